@@ -0,0 +1,168 @@
+#include <alice/alice.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <fmt/format.h>
+#include <lorina/aiger.hpp>
+#include <lorina/verilog.hpp>
+#include <mockturtle/io/aiger_reader.hpp>
+#include <mockturtle/io/verilog_reader.hpp>
+#include <mockturtle/networks/aig.hpp>
+
+#include "../utils/cirkit_command.hpp"
+#include "../utils/equivalence_checking.hpp"
+#include "../utils/read_aiger.hpp"
+
+namespace alice
+{
+
+class cec_command : public cirkit::cirkit_command<cec_command, aig_t, mig_t, xag_t, xmg_t>
+{
+public:
+  cec_command( environment::ptr& env ) : cirkit::cirkit_command<cec_command, aig_t, mig_t, xag_t, xmg_t>( env, "Combinational equivalence checking", "check equivalence of {1}" )
+  {
+    add_option( "--first", first, "index of first store entry (default: current)" );
+    add_option( "--second", second, "index of second store entry" );
+    add_option( "--file,-f", filename, "compare against AIGER or Verilog file (.v) instead of second store entry" );
+    add_option( "--patterns", ps.num_patterns, "number of random simulation patterns", true );
+    add_option( "--seed", ps.seed, "random seed for simulation patterns", true );
+    add_option( "--conflict_limit", ps.conflict_limit, "conflict limit for internal SAT calls (0 for no limit)", true );
+    add_option( "--output_conflict_limit", ps.output_conflict_limit, "conflict limit for SAT calls on outputs (0 for no limit)", true );
+    add_flag( "-v,--verbose", "show statistics" );
+  }
+
+  rules validity_rules() const override
+  {
+    auto r = cirkit::cirkit_command<cec_command, aig_t, mig_t, xag_t, xmg_t>::validity_rules();
+    r.push_back( {[this]() { return is_set( "second" ) != is_set( "file" ); }, "either a second store entry or a file must be specified"} );
+    return r;
+  }
+
+  template<class Store>
+  inline void execute_store()
+  {
+    equivalent = false;
+    undecided = false;
+    counterexample.clear();
+    st = {};
+
+    auto const& ntks = store<Store>();
+    const auto index1 = is_set( "first" ) ? first : static_cast<unsigned>( ntks.current_index() );
+    if ( index1 >= ntks.size() || ( is_set( "second" ) && second >= ntks.size() ) )
+    {
+      env->err() << fmt::format( "[e] store has only {} entries\n", ntks.size() );
+      return;
+    }
+    const auto& ntk1 = *ntks[index1];
+
+    if ( is_set( "file" ) )
+    {
+      mockturtle::aig_network aig;
+      try
+      {
+        if ( !read_network( filename, aig ) )
+        {
+          env->err() << "[e] could not parse " << filename << "\n";
+          return;
+        }
+      }
+      catch ( std::string const& e )
+      {
+        env->err() << "[e] " << e << "\n";
+        return;
+      }
+      check( ntk1, aig );
+    }
+    else
+    {
+      check( ntk1, *ntks[second] );
+    }
+  }
+
+  nlohmann::json log() const override
+  {
+    nlohmann::json j{
+        {"equivalent", equivalent},
+        {"undecided", undecided},
+        {"merges", st.num_merges},
+        {"sat_calls", st.num_sat_calls},
+        {"undecided_calls", st.num_undecided}};
+    if ( !counterexample.empty() )
+    {
+      j["counterexample"] = counterexample;
+      j["output"] = output;
+    }
+    return j;
+  }
+
+private:
+  static bool read_network( std::string const& path, mockturtle::aig_network& aig )
+  {
+    if ( path.size() >= 2u && path.compare( path.size() - 2u, 2u, ".v" ) == 0 )
+    {
+      return lorina::read_verilog( path, mockturtle::verilog_reader( aig ) ) == lorina::return_code::success;
+    }
+    return cirkit::read_aiger_mapped( path, aig ) || lorina::read_aiger( path, mockturtle::aiger_reader( aig ) ) == lorina::return_code::success;
+  }
+
+  template<class Ntk1, class Ntk2>
+  void check( Ntk1 const& ntk1, Ntk2 const& ntk2 )
+  {
+    if ( ntk1.num_pis() != ntk2.num_pis() || ntk1.num_pos() != ntk2.num_pos() )
+    {
+      env->err() << fmt::format( "[e] networks have different interfaces (i/o = {}/{} and {}/{})\n", ntk1.num_pis(), ntk1.num_pos(), ntk2.num_pis(), ntk2.num_pos() );
+      return;
+    }
+
+    const auto result = cirkit::equivalence_checking( ntk1, ntk2, ps, &st );
+    equivalent = result.equivalent;
+
+    if ( is_set( "verbose" ) )
+    {
+      env->out() << fmt::format( "[i] nodes = {}   merges = {}   SAT calls = {}   counterexamples = {}   undecided = {}\n",
+                                 st.num_nodes, st.num_merges, st.num_sat_calls, st.num_counterexamples, st.num_undecided );
+    }
+
+    if ( equivalent )
+    {
+      env->out() << "[i] networks are equivalent\n";
+      return;
+    }
+    if ( result.undecided )
+    {
+      undecided = true;
+      output = result.output;
+      env->err() << fmt::format( "[w] equivalence is undecided, output {} could not be proved within the conflict limit\n", output );
+      return;
+    }
+
+    /* first input first, as in simulation pattern files */
+    counterexample.assign( result.counterexample.size(), '0' );
+    for ( auto i = 0u; i < result.counterexample.size(); ++i )
+    {
+      if ( result.counterexample[i] )
+      {
+        counterexample[i] = '1';
+      }
+    }
+    output = result.output;
+    env->out() << fmt::format( "[i] networks are not equivalent, output {} differs for input {}\n", output, counterexample );
+  }
+
+private:
+  unsigned first{0u};
+  unsigned second{0u};
+  std::string filename;
+  cirkit::equivalence_checking_params ps;
+  cirkit::equivalence_checking_stats st;
+
+  bool equivalent{false};
+  bool undecided{false};
+  std::string counterexample;
+  uint32_t output{0u};
+};
+
+ALICE_ADD_COMMAND( cec, "Verification" )
+
+} // namespace alice
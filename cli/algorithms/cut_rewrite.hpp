@@ -12,6 +12,9 @@
 #include <mockturtle/algorithms/node_resynthesis/xmg_npn.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/cleanup_inplace.hpp"
+#include "../utils/exact_cache.hpp"
+#include "../utils/parallel_exact.hpp"
 
 namespace alice
 {
@@ -31,10 +34,13 @@ public:
     add_flag( "--greedy", "use Greedy candidate selection" );
     add_flag( "--dont_cares", "use don't cares if possible" );
     add_flag( "--clear_cache", "clear network cache" );
+    add_option( "--cache_file", cache_file, "load exact synthesis cache from file before and save it after rewriting" );
     add_option( "--exact_lutsize", exact_lutsize, "LUT size for exact resynthesis", true );
     add_option( "--conflict_limit", conflict_limit, "conflict limit for exact resynthesis", true );
+    add_option( "--threads", num_threads, "number of threads for exact resynthesis", true );
     add_flag( "-p,--progress", ps.progress, "show progress" );
     add_flag( "-v,--verbose", ps.verbose, "show statistics" );
+    set_in_place();
   }
 
   template<class Store>
@@ -52,28 +58,28 @@ public:
         auto* aig_p = static_cast<mockturtle::aig_network*>( store<Store>().current().get() );
         mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn;
         mockturtle::cut_rewriting( *aig_p, resyn, ps, &st );
-        *aig_p = cleanup_dangling( *aig_p );
+        cirkit::cleanup_dangling_inplace( *aig_p );
       }
       else if constexpr (std::is_same_v<Store, xag_t> )
       {
         auto* xag_p = static_cast<mockturtle::xag_network*>( store<Store>().current().get() );
         mockturtle::xag_npn_resynthesis<mockturtle::xag_network> resyn;
         mockturtle::cut_rewriting( *xag_p, resyn, ps, &st );
-        *xag_p = cleanup_dangling( *xag_p );
+        cirkit::cleanup_dangling_inplace( *xag_p );
       }
       else if constexpr ( std::is_same_v<Store, mig_t> )
       {
         auto* mig_p = static_cast<mockturtle::mig_network*>( store<Store>().current().get() );
         mockturtle::mig_npn_resynthesis resyn( is_set( "multiple" ) );
         mockturtle::cut_rewriting( *mig_p, resyn, ps, &st );
-        *mig_p = cleanup_dangling( *mig_p );
+        cirkit::cleanup_dangling_inplace( *mig_p );
       }
       else if constexpr ( std::is_same_v<Store, xmg_t> )
       {
         auto* xmg_p = static_cast<mockturtle::xmg_network*>( store<Store>().current().get() );
         mockturtle::xmg_npn_resynthesis resyn;
         mockturtle::cut_rewriting( *xmg_p, resyn, ps, &st );
-        *xmg_p = cleanup_dangling( *xmg_p );
+        cirkit::cleanup_dangling_inplace( *xmg_p );
       }
       else
       {
@@ -90,12 +96,17 @@ public:
         {
           exact_cache = std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>();
         }
+        const auto save_cache = !is_set( "cache_file" ) || cirkit::read_exact_cache_file( cache_file, cirkit::exact_cache_kind::lut, exact_lutsize, *exact_cache, env->err() );
         mockturtle::exact_resynthesis_params esps;
         esps.cache = exact_cache;
         esps.conflict_limit = conflict_limit;
         mockturtle::exact_resynthesis resyn( exact_lutsize, esps );
-        mockturtle::cut_rewriting( *klut_p, resyn, ps, &st );
-        *klut_p = cleanup_dangling( *klut_p );
+        exact_cut_rewriting( *klut_p, resyn, exact_lutsize, esps, [&]( auto const& eps ) { return mockturtle::exact_resynthesis( exact_lutsize, eps ); } );
+        if ( is_set( "cache_file" ) && save_cache )
+        {
+          cirkit::write_exact_cache_file( cache_file, cirkit::exact_cache_kind::lut, exact_lutsize, *exact_cache, env->err() );
+        }
+        cirkit::cleanup_dangling_inplace( *klut_p );
       }
       else if constexpr ( std::is_same_v<Store, aig_t> )
       {
@@ -104,12 +115,17 @@ public:
         {
           exact_aig_cache = std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>();
         }
+        const auto save_cache = !is_set( "cache_file" ) || cirkit::read_exact_cache_file( cache_file, cirkit::exact_cache_kind::aig, 2u, *exact_aig_cache, env->err() );
         mockturtle::exact_resynthesis_params esps;
         esps.cache = exact_aig_cache;
         esps.conflict_limit = conflict_limit;
         mockturtle::exact_aig_resynthesis resyn( esps );
-        mockturtle::cut_rewriting( *aig_p, resyn, ps, &st );
-        *aig_p = cleanup_dangling( *aig_p );
+        exact_cut_rewriting( *aig_p, resyn, 2u, esps, [&]( auto const& eps ) { return mockturtle::exact_aig_resynthesis( eps ); } );
+        if ( is_set( "cache_file" ) && save_cache )
+        {
+          cirkit::write_exact_cache_file( cache_file, cirkit::exact_cache_kind::aig, 2u, *exact_aig_cache, env->err() );
+        }
+        cirkit::cleanup_dangling_inplace( *aig_p );
       }
       else if constexpr ( std::is_same_v<Store, xag_t> )
       {
@@ -119,12 +135,17 @@ public:
         {
           exact_xag_cache = std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>();
         }
+        const auto save_cache = !is_set( "cache_file" ) || cirkit::read_exact_cache_file( cache_file, cirkit::exact_cache_kind::xag, 2u, *exact_xag_cache, env->err() );
         mockturtle::exact_resynthesis_params esps;
         esps.cache = exact_xag_cache;
         esps.conflict_limit = conflict_limit;
         mockturtle::exact_resynthesis resyn( 2u, esps );
-        mockturtle::cut_rewriting( klut, resyn, ps, &st );
-        klut = cleanup_dangling( klut );
+        exact_cut_rewriting( klut, resyn, 2u, esps, [&]( auto const& eps ) { return mockturtle::exact_resynthesis( 2u, eps ); } );
+        if ( is_set( "cache_file" ) && save_cache )
+        {
+          cirkit::write_exact_cache_file( cache_file, cirkit::exact_cache_kind::xag, 2u, *exact_xag_cache, env->err() );
+        }
+        cirkit::cleanup_dangling_inplace( klut );
 
         mockturtle::direct_resynthesis<mockturtle::xag_network> dresyn;
         *xag_p = mockturtle::node_resynthesis<mockturtle::xag_network>( klut, dresyn );
@@ -142,7 +163,7 @@ public:
         auto* mig_p = static_cast<mockturtle::mig_network*>( store<Store>().current().get() );
         mockturtle::akers_resynthesis<mockturtle::mig_network> resyn;
         mockturtle::cut_rewriting( *mig_p, resyn, ps, &st );
-        *mig_p = cleanup_dangling( *mig_p );
+        cirkit::cleanup_dangling_inplace( *mig_p );
       }
       else
       {
@@ -153,6 +174,28 @@ public:
     }
   }
 
+private:
+  /* with several threads, the exact synthesis problems of all cuts are solved concurrently while rewriting */
+  template<class Ntk, class Resyn, class ResynFn>
+  void exact_cut_rewriting( Ntk& ntk, Resyn& resyn, uint32_t fanin, mockturtle::exact_resynthesis_params const& esps, ResynFn&& make_resyn )
+  {
+    if ( num_threads <= 1u || ps.use_dont_cares )
+    {
+      mockturtle::cut_rewriting( ntk, resyn, ps, &st );
+      return;
+    }
+
+    auto functions = cirkit::uncached_cut_functions( ntk, ps.cut_enumeration_ps, fanin, *esps.cache );
+    const auto solve = [&]( kitty::dynamic_truth_table const& function, percy::chain& chain ) {
+      return cirkit::solve_exact_function<Ntk>( function, make_resyn, esps, chain );
+    };
+
+    cirkit::parallel_exact_resynthesis<Ntk, Resyn> presyn( resyn, esps.cache, std::move( functions ), solve, num_threads - 1u );
+    mockturtle::cut_rewriting( ntk, presyn, ps, &st );
+    presyn.finish();
+  }
+
+public:
   nlohmann::json log() const override
   {
     return {
@@ -166,9 +209,11 @@ private:
   mockturtle::exact_resynthesis_params::cache_t exact_cache{std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>()}; 
   mockturtle::exact_resynthesis_params::cache_t exact_aig_cache{std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>()}; 
   mockturtle::exact_resynthesis_params::cache_t exact_xag_cache{std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>()}; 
+  std::string cache_file;
   unsigned strategy{0u};
   unsigned exact_lutsize{3u};
   int conflict_limit{0};
+  unsigned num_threads{1u};
 };
 
 ALICE_ADD_COMMAND( cut_rewrite, "Synthesis" )
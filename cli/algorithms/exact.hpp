@@ -6,6 +6,7 @@
 #include <mockturtle/algorithms/node_resynthesis/exact.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/exact_cache.hpp"
 
 namespace alice
 {
@@ -16,6 +17,7 @@ public:
   exact_command( environment::ptr& env ) : cirkit::cirkit_command<exact_command, aig_t, klut_t>( env, "Finds optimum network", "find optimum {}" )
   {
     add_flag( "--clear_cache", "clear network cache" );
+    add_option( "--cache_file", cache_file, "load exact synthesis cache from file before and save it after synthesis" );
     add_option( "--lutsize", lutsize, "LUT size for k-LUT synthesis", true );
     add_option( "--conflict_limit", conflict_limit, "conflict limit", true );
     add_new_option();
@@ -37,6 +39,7 @@ public:
       {
         exact_aig_cache = std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>();
       }
+      const auto save_cache = !is_set( "cache_file" ) || cirkit::read_exact_cache_file( cache_file, cirkit::exact_cache_kind::aig, 2u, *exact_aig_cache, env->err() );
 
       mockturtle::exact_resynthesis_params esps;
       esps.cache = exact_aig_cache;
@@ -49,6 +52,11 @@ public:
 
       resyn( ntk, tt, pis.begin(), pis.end(), [&]( auto const& f ) { ntk.create_po( f ); } );
 
+      if ( is_set( "cache_file" ) && save_cache )
+      {
+        cirkit::write_exact_cache_file( cache_file, cirkit::exact_cache_kind::aig, 2u, *exact_aig_cache, env->err() );
+      }
+
       if ( ntk.num_pos() == 1u )
       {
         extend_if_new<aig_t>();
@@ -62,6 +70,7 @@ public:
       {
         exact_cache = std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>();
       }
+      const auto save_cache = !is_set( "cache_file" ) || cirkit::read_exact_cache_file( cache_file, cirkit::exact_cache_kind::lut, lutsize, *exact_cache, env->err() );
 
       mockturtle::exact_resynthesis_params esps;
       esps.cache = exact_cache;
@@ -74,6 +83,11 @@ public:
 
       resyn( ntk, tt, pis.begin(), pis.end(), [&]( auto const& f ) { ntk.create_po( f ); } );
 
+      if ( is_set( "cache_file" ) && save_cache )
+      {
+        cirkit::write_exact_cache_file( cache_file, cirkit::exact_cache_kind::lut, lutsize, *exact_cache, env->err() );
+      }
+
       if ( ntk.num_pos() == 1u )
       {
         extend_if_new<klut_t>();
@@ -86,6 +100,7 @@ public:
 private:
   mockturtle::exact_resynthesis_params::cache_t exact_cache{std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>()};
   mockturtle::exact_resynthesis_params::cache_t exact_aig_cache{std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>()};
+  std::string cache_file;
   unsigned lutsize{3u};
   int conflict_limit{0};
 };
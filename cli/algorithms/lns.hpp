@@ -1,6 +1,11 @@
 #include <alice/alice.hpp>
 
+#include <algorithm>
+#include <cstdint>
+
 #include <caterpillar/lhrs.hpp>
+#include <fmt/format.h>
+#include <tweedledum/gates/gate_kinds.hpp>
 
 #include "../utils/cirkit_command.hpp"
 
@@ -13,6 +18,8 @@ public:
   lns_command( environment::ptr& env ) : cirkit::cirkit_command<lns_command, aig_t, mig_t, xag_t, xmg_t, klut_t>( env, "Logic network based hierarchical synthesis", "hierarchical synthesis from {0}" )
   {
     add_flag( "--outofplace", "use always out-of-place mapping" );
+    add_option( "--max_qubits", pebbling_ps.max_qubits, "compute a pebbling strategy with at most this number of qubits" );
+    add_option( "--ancilla_policy", ancilla_policy, "order in which released ancillae are reused", true )->set_type_name( "policy in {lifo=0, fifo=1, lru=2}" );
     add_flag( "-v,--verbose", "be verbose" );
   }
 
@@ -20,6 +27,8 @@ public:
   inline void execute_store()
   {
     ps.verbose = is_set( "verbose" );
+    ps.ancilla_policy = static_cast<tweedledum::ancilla_policy_t>( std::min( ancilla_policy, 2u ) );
+    st = {};
     auto& circs = store<qcircuit_t>();
     if ( circs.empty() || is_set( "new" ) )
     {
@@ -28,18 +37,81 @@ public:
     circs.current() = qcircuit_t();
 
     using LogicNetwork = typename Store::element_type;
-    if ( is_set( "outofplace" ) )
+    if ( is_set( "max_qubits" ) )
+    {
+      const auto& ntk = *( store<Store>().current() );
+      tweedledum::pebbling_mapping_strategy<LogicNetwork> strategy( ntk, pebbling_ps );
+      if ( !strategy.success() )
+      {
+        env->err() << fmt::format( "[e] no pebbling strategy with at most {} qubits found\n", pebbling_ps.max_qubits );
+        return;
+      }
+      tweedledum::logic_network_synthesis( circs.current(), ntk, strategy, ps, &st );
+      env->out() << fmt::format( "[i] qubits = {}   T-count = {}   depth = {}   steps = {}\n", circs.current().num_qubits(), t_count( circs.current() ), st.depth, strategy.num_steps() );
+    }
+    else if ( is_set( "outofplace" ) )
     {
-      tweedledum::logic_network_synthesis<qcircuit_t, LogicNetwork, typename tweedledum::bennett_mapping_strategy<LogicNetwork>>( circs.current(), *( store<Store>().current() ), ps );
+      tweedledum::logic_network_synthesis<qcircuit_t, LogicNetwork, typename tweedledum::bennett_mapping_strategy<LogicNetwork>>( circs.current(), *( store<Store>().current() ), ps, &st );
     }
     else
     {
-      tweedledum::logic_network_synthesis<qcircuit_t, LogicNetwork, typename tweedledum::bennett_inplace_mapping_strategy<LogicNetwork>>( circs.current(), *( store<Store>().current() ), ps );
+      tweedledum::logic_network_synthesis<qcircuit_t, LogicNetwork, typename tweedledum::bennett_inplace_mapping_strategy<LogicNetwork>>( circs.current(), *( store<Store>().current() ), ps, &st );
+    }
+  }
+
+  nlohmann::json log() const override
+  {
+    if ( store<qcircuit_t>().empty() )
+    {
+      return nullptr;
     }
+    const auto& circ = store<qcircuit_t>().current();
+    return {
+        {"qubits", circ.num_qubits()},
+        {"gates", circ.num_gates()},
+        {"t_count", t_count( circ )},
+        {"ancillae", st.num_ancillae},
+        {"depth", st.depth},
+        {"output_qubits", st.output_qubits}};
+  }
+
+private:
+  /* T-count estimate: multiple-controlled Toffoli gates with c >= 2 controls
+     are counted with 8c - 9 T gates, i.e., 7 for a Toffoli gate */
+  static uint64_t t_count( qcircuit_t const& circ )
+  {
+    uint64_t count{0u};
+    circ.foreach_cgate( [&]( auto const& node ) {
+      auto const& gate = node.gate;
+      switch ( gate.kind() )
+      {
+      case tweedledum::gate_kinds_t::t:
+      case tweedledum::gate_kinds_t::t_dagger:
+        ++count;
+        break;
+      case tweedledum::gate_kinds_t::mcx:
+      case tweedledum::gate_kinds_t::mcz:
+      {
+        uint64_t controls{0u};
+        gate.foreach_control( [&]( auto ) { ++controls; } );
+        if ( controls >= 2u )
+        {
+          count += 8u * controls - 9u;
+        }
+      }
+      break;
+      default:
+        break;
+      }
+    } );
+    return count;
   }
 
 private:
   tweedledum::logic_network_synthesis_params ps;
+  tweedledum::pebbling_mapping_strategy_params pebbling_ps;
+  tweedledum::logic_network_synthesis_stats st;
+  uint32_t ancilla_policy{0u};
 };
 
 ALICE_ADD_COMMAND( lns, "Synthesis" )
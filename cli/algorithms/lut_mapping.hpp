@@ -4,6 +4,7 @@
 #include <mockturtle/algorithms/lut_mapping.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/parallel_lut_mapping.hpp"
 
 namespace alice
 {
@@ -17,12 +18,25 @@ public:
     add_option( "--lutcount", ps.cut_enumeration_ps.cut_limit, "number of cuts per node", true );
     add_option( "--cost", cost, "cost function for priority cut selection", true )->set_type_name( "cost function in {mf=0, spectral=1}");
     add_flag( "--nofun", "do not compute cut functions (only when cost function is 0)" );
+    add_option( "--threads", num_threads, "map with level-parallel cut enumeration using this number of threads (only when cost function is 0); this mapper may give a different mapping than the default one, but the same for every number of threads" );
+    set_in_place();
   }
 
   template<class Store>
   inline void execute_store()
   {
-    if ( is_set( "nofun" ) )
+    if ( is_set( "threads" ) && cost == 0u )
+    {
+      if ( is_set( "nofun" ) )
+      {
+        cirkit::parallel_lut_mapping( *( store<Store>().current() ), ps, num_threads );
+      }
+      else
+      {
+        cirkit::parallel_lut_mapping<typename Store::element_type, true>( *( store<Store>().current() ), ps, num_threads );
+      }
+    }
+    else if ( is_set( "nofun" ) )
     {
       mockturtle::lut_mapping( *( store<Store>().current() ), ps );
     }
@@ -49,6 +63,7 @@ public:
 private:
   mockturtle::lut_mapping_params ps;
   unsigned cost{0u};
+  unsigned num_threads{1u};
 };
 
 ALICE_ADD_COMMAND( lut_mapping, "Mapping" )
@@ -5,6 +5,7 @@
 #include <mockturtle/views/depth_view.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/cleanup_inplace.hpp"
 
 namespace alice
 {
@@ -20,6 +21,7 @@ public:
                    mockturtle::mig_algebraic_depth_rewriting_params::selective},
                   "optimization strategy", true )->set_type_name( "enum/strategy in {dfs=0, aggressive=1, selective=2}" );
     opts.add_flag( "--area_aware", "do not increase area" );
+    set_in_place();
   }
 
   template<class Store>
@@ -29,7 +31,7 @@ public:
     mockturtle::depth_view depth_mig{*mig_p};
     ps.allow_area_increase = !is_set( "area_aware" );
     mockturtle::mig_algebraic_depth_rewriting( depth_mig, ps );
-    *mig_p = mockturtle::cleanup_dangling( *mig_p );
+    cirkit::cleanup_dangling_inplace( *mig_p );
   }
 
 private:
@@ -9,6 +9,7 @@
 #include <mockturtle/utils/stopwatch.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/cleanup_inplace.hpp"
 
 namespace alice
 {
@@ -36,6 +37,7 @@ public:
     add_option( "--load", db, "load database" );
     add_flag( "--verify" , "verify database when loading" );
     add_flag( "--verbose,-v", ps.verbose, "be verbose" );
+    set_in_place();
   }
 
   rules validity_rules() const override
@@ -65,7 +67,7 @@ public:
 
       auto* xag_p = static_cast<mockturtle::xag_network*>( store<xag_t>().current().get() );
       mockturtle::cut_rewriting( *xag_p, *resyn, ps, &st, detail::mc_cost<mockturtle::xag_network>() );
-      *xag_p = mockturtle::cleanup_dangling( *xag_p );
+      cirkit::cleanup_dangling_inplace( *xag_p );
     }
   }
 
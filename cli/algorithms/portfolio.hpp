@@ -0,0 +1,373 @@
+#include <alice/alice.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <mockturtle/algorithms/aig_resub.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/mig_algebraic_rewriting.hpp>
+#include <mockturtle/algorithms/mig_resub.hpp>
+#include <mockturtle/algorithms/node_resynthesis/akers.hpp>
+#include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xmg_npn.hpp>
+#include <mockturtle/algorithms/refactoring.hpp>
+#include <mockturtle/algorithms/resubstitution.hpp>
+#include <mockturtle/utils/stopwatch.hpp>
+#include <mockturtle/views/depth_view.hpp>
+#include <mockturtle/views/fanout_view.hpp>
+
+#include "../utils/cirkit_command.hpp"
+#include "../utils/cleanup_inplace.hpp"
+
+namespace alice
+{
+
+namespace detail
+{
+
+/* one step of a flow, mirrors the aliases in cirkit.rs */
+struct portfolio_step
+{
+  enum kind_t
+  {
+    rewrite,  /* rw, rwz */
+    refactor, /* rf, rfz */
+    resub,    /* rs */
+    balance   /* bz */
+  };
+
+  kind_t kind;
+  bool zero_gain{false};
+  uint32_t max_pis{0u};
+  uint32_t max_inserts{0u};
+};
+
+/* parameters that are varied among the parallel runs */
+struct portfolio_variant
+{
+  uint32_t cut_size;
+  uint32_t resub_offset;
+  mockturtle::mig_algebraic_depth_rewriting_params::strategy_t strategy;
+};
+
+inline std::vector<portfolio_step> portfolio_flow( unsigned flow )
+{
+  using s = portfolio_step;
+
+  switch ( flow )
+  {
+  default:
+  case 0u: /* compress2 */
+    return {{s::balance}, {s::rewrite}, {s::refactor}, {s::balance}, {s::rewrite}, {s::rewrite, true}, {s::balance}, {s::refactor, true}, {s::rewrite, true}, {s::balance}};
+  case 1u: /* compress2rs */
+    return {{s::balance}, {s::resub, false, 6u}, {s::rewrite}, {s::resub, false, 6u, 2u}, {s::refactor}, {s::resub, false, 8u}, {s::balance}, {s::resub, false, 8u, 2u}, {s::rewrite}, {s::resub, false, 10u}, {s::rewrite, true}, {s::resub, false, 10u, 2u}, {s::balance}, {s::resub, false, 12u}, {s::refactor, true}, {s::resub, false, 12u, 2u}, {s::rewrite, true}, {s::balance}};
+  case 2u: /* shake */
+    return {{s::rewrite}, {s::refactor}, {s::refactor, true}, {s::rewrite, true}, {s::refactor, true}};
+  }
+}
+
+/* variant 0 corresponds to the flow as defined by the aliases */
+inline portfolio_variant portfolio_variant_at( uint32_t index )
+{
+  constexpr mockturtle::mig_algebraic_depth_rewriting_params::strategy_t strategies[] = {
+      mockturtle::mig_algebraic_depth_rewriting_params::dfs,
+      mockturtle::mig_algebraic_depth_rewriting_params::aggressive,
+      mockturtle::mig_algebraic_depth_rewriting_params::selective};
+
+  return {( index / 3u ) % 2u == 0u ? 4u : 3u, ( index / 6u ) % 2u == 0u ? 0u : 2u, strategies[index % 3u]};
+}
+
+template<class Ntk>
+void portfolio_apply_step( Ntk& ntk, portfolio_step const& step, portfolio_variant const& variant )
+{
+  switch ( step.kind )
+  {
+  case portfolio_step::rewrite:
+  {
+    mockturtle::cut_rewriting_params ps;
+    ps.cut_enumeration_ps.cut_size = variant.cut_size;
+    ps.cut_enumeration_ps.cut_limit = 25u;
+    ps.allow_zero_gain = step.zero_gain;
+    ps.candidate_selection_strategy = mockturtle::cut_rewriting_params::minimize_weight;
+
+    if constexpr ( std::is_same_v<Ntk, mockturtle::mig_network> )
+    {
+      mockturtle::mig_npn_resynthesis resyn( true );
+      mockturtle::cut_rewriting( ntk, resyn, ps );
+    }
+    else if constexpr ( std::is_same_v<Ntk, mockturtle::xmg_network> )
+    {
+      mockturtle::xmg_npn_resynthesis resyn;
+      mockturtle::cut_rewriting( ntk, resyn, ps );
+    }
+    else
+    {
+      mockturtle::xag_npn_resynthesis<Ntk> resyn;
+      mockturtle::cut_rewriting( ntk, resyn, ps );
+    }
+    cirkit::cleanup_dangling_inplace( ntk );
+  }
+  break;
+
+  case portfolio_step::refactor:
+  {
+    if constexpr ( std::is_same_v<Ntk, mockturtle::mig_network> || std::is_same_v<Ntk, mockturtle::xmg_network> )
+    {
+      mockturtle::refactoring_params ps;
+      ps.allow_zero_gain = step.zero_gain;
+
+      mockturtle::akers_resynthesis<Ntk> resyn;
+      mockturtle::refactoring( ntk, resyn, ps );
+      cirkit::cleanup_dangling_inplace( ntk );
+    }
+  }
+  break;
+
+  case portfolio_step::resub:
+  {
+    mockturtle::resubstitution_params ps;
+    ps.max_pis = step.max_pis + variant.resub_offset;
+    if ( step.max_inserts != 0u )
+    {
+      ps.max_inserts = step.max_inserts;
+    }
+
+    using view_t = mockturtle::depth_view<mockturtle::fanout_view<Ntk>>;
+    mockturtle::fanout_view<Ntk> fanout_view{ntk};
+    view_t resub_view{fanout_view};
+
+    if constexpr ( std::is_same_v<Ntk, mockturtle::aig_network> )
+    {
+      mockturtle::aig_resubstitution( resub_view, ps );
+    }
+    else if constexpr ( std::is_same_v<Ntk, mockturtle::mig_network> )
+    {
+      mockturtle::mig_resubstitution( resub_view, ps );
+    }
+    else
+    {
+      mockturtle::resubstitution( resub_view, ps );
+    }
+    cirkit::cleanup_dangling_inplace( ntk );
+  }
+  break;
+
+  case portfolio_step::balance:
+  {
+    if constexpr ( std::is_same_v<Ntk, mockturtle::mig_network> )
+    {
+      mockturtle::mig_algebraic_depth_rewriting_params ps;
+      ps.strategy = variant.strategy;
+      ps.allow_area_increase = false;
+
+      mockturtle::depth_view depth_mig{ntk};
+      mockturtle::mig_algebraic_depth_rewriting( depth_mig, ps );
+      cirkit::cleanup_dangling_inplace( ntk );
+    }
+  }
+  break;
+  }
+}
+
+} // namespace detail
+
+class portfolio_command : public cirkit::cirkit_command<portfolio_command, aig_t, mig_t, xag_t, xmg_t>
+{
+public:
+  portfolio_command( environment::ptr& env ) : cirkit::cirkit_command<portfolio_command, aig_t, mig_t, xag_t, xmg_t>( env, "Runs flow variants in parallel and keeps the best result", "run portfolio on {0}" )
+  {
+    add_option( "--flow", flow, "optimization flow", true )->set_type_name( "flow in {compress2=0, compress2rs=1, shake=2}" );
+    add_option( "--variants", num_variants, "number of flow variants (at most 12)", true );
+    add_option( "--threads", num_threads, "number of threads (0 uses all cores)", true );
+    add_flag( "--depth", "select result with minimum depth instead of minimum size" );
+    add_flag( "-v,--verbose", "show statistics for each variant" );
+    add_new_option();
+    set_in_place();
+  }
+
+  rules validity_rules() const override
+  {
+    auto r = cirkit::cirkit_command<portfolio_command, aig_t, mig_t, xag_t, xmg_t>::validity_rules();
+    r.push_back( {[this]() { return num_variants >= 1u && num_variants <= 12u; }, "number of variants must be between 1 and 12"} );
+    return r;
+  }
+
+  template<class Store>
+  inline void execute_store()
+  {
+    using Ntk = typename Store::element_type::base_type;
+
+    results.clear();
+    failed.clear();
+    time_total = {};
+
+    const auto steps = detail::portfolio_flow( flow );
+
+    /* copies are created serially, since cleanup_dangling updates traversal ids in the source */
+    std::vector<Ntk> ntks;
+    ntks.reserve( num_variants );
+    for ( auto i = 0u; i < num_variants; ++i )
+    {
+      ntks.push_back( mockturtle::cleanup_dangling( static_cast<Ntk const&>( *store<Store>().current() ) ) );
+    }
+
+    std::vector<uint32_t> depths( num_variants );
+    std::vector<std::exception_ptr> errors( num_variants );
+    {
+      mockturtle::stopwatch t( time_total );
+
+      std::atomic<uint32_t> next{0u};
+      const auto worker = [&]() {
+        for ( auto i = next++; i < num_variants; i = next++ )
+        {
+          /* a failing variant must not terminate the process, it is reported after all workers are joined */
+          try
+          {
+            const auto variant = detail::portfolio_variant_at( i );
+            for ( auto const& step : steps )
+            {
+              detail::portfolio_apply_step( ntks[i], step, variant );
+            }
+            depths[i] = mockturtle::depth_view{ntks[i]}.depth();
+          }
+          catch ( ... )
+          {
+            errors[i] = std::current_exception();
+          }
+        }
+      };
+
+      auto threads = num_threads == 0u ? std::thread::hardware_concurrency() : num_threads;
+      threads = std::max( 1u, std::min( threads, num_variants ) );
+
+      std::vector<std::thread> workers;
+      for ( auto t = 1u; t < threads; ++t )
+      {
+        try
+        {
+          workers.emplace_back( worker );
+        }
+        catch ( const std::system_error& )
+        {
+          /* continue with the threads that could be started */
+          break;
+        }
+      }
+      worker();
+      for ( auto& w : workers )
+      {
+        w.join();
+      }
+    }
+
+    /* failed variants are skipped; if all of them failed, the first error is raised */
+    std::exception_ptr first_error;
+    for ( auto i = 0u; i < num_variants; ++i )
+    {
+      failed.push_back( errors[i] != nullptr );
+      results.push_back( failed[i] ? std::make_pair( 0u, 0u ) : std::make_pair( ntks[i].num_gates(), depths[i] ) );
+      if ( !errors[i] )
+      {
+        continue;
+      }
+
+      if ( !first_error )
+      {
+        first_error = errors[i];
+      }
+      std::string message = "unknown error";
+      try
+      {
+        std::rethrow_exception( errors[i] );
+      }
+      catch ( const std::exception& e )
+      {
+        message = e.what();
+      }
+      catch ( ... )
+      {
+      }
+      env->err() << fmt::format( "[w] variant {} failed: {}\n", i, message );
+    }
+    if ( std::find( failed.begin(), failed.end(), false ) == failed.end() )
+    {
+      results.clear();
+      failed.clear();
+      std::rethrow_exception( first_error );
+    }
+
+    /* ties are broken by the variant index to keep the result deterministic */
+    const auto cost = [&]( uint32_t i ) {
+      return is_set( "depth" ) ? std::make_pair( results[i].second, results[i].first ) : results[i];
+    };
+    best = static_cast<uint32_t>( std::find( failed.begin(), failed.end(), false ) - failed.begin() );
+    for ( auto i = best + 1u; i < num_variants; ++i )
+    {
+      if ( !failed[i] && cost( i ) < cost( best ) )
+      {
+        best = i;
+      }
+    }
+
+    if ( is_set( "verbose" ) )
+    {
+      for ( auto i = 0u; i < num_variants; ++i )
+      {
+        const auto variant = detail::portfolio_variant_at( i );
+        if ( failed[i] )
+        {
+          env->out() << fmt::format( "[i] variant {:2}: k = {}   resub offset = {}   strategy = {}   failed\n",
+                                     i, variant.cut_size, variant.resub_offset, static_cast<uint32_t>( variant.strategy ) );
+          continue;
+        }
+        env->out() << fmt::format( "[i] variant {:2}: k = {}   resub offset = {}   strategy = {}   gates = {}   level = {}{}\n",
+                                   i, variant.cut_size, variant.resub_offset, static_cast<uint32_t>( variant.strategy ),
+                                   results[i].first, results[i].second, i == best ? "   *" : "" );
+      }
+    }
+
+    extend_if_new<Store>();
+    store<Store>().current() = std::make_shared<typename Store::element_type>( ntks[best] );
+  }
+
+  nlohmann::json log() const override
+  {
+    nlohmann::json variants = nlohmann::json::array();
+    for ( auto i = 0u; i < results.size(); ++i )
+    {
+      const auto variant = detail::portfolio_variant_at( i );
+      variants.push_back( {{"cut_size", variant.cut_size},
+                           {"resub_offset", variant.resub_offset},
+                           {"strategy", static_cast<uint32_t>( variant.strategy )},
+                           {"gates", results[i].first},
+                           {"depth", results[i].second},
+                           {"failed", static_cast<bool>( failed[i] )}} );
+    }
+
+    return {
+        {"variants", variants},
+        {"best", best},
+        {"time_total", mockturtle::to_seconds( time_total )}};
+  }
+
+private:
+  unsigned flow{1u};
+  unsigned num_variants{6u};
+  unsigned num_threads{0u};
+
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::vector<bool> failed;
+  uint32_t best{0u};
+  mockturtle::stopwatch<>::duration time_total{};
+};
+
+ALICE_ADD_COMMAND( portfolio, "Synthesis" )
+
+} // namespace alice
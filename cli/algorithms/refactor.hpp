@@ -7,6 +7,7 @@
 #include <mockturtle/algorithms/node_resynthesis/xmg_npn.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/cleanup_inplace.hpp"
 
 namespace alice
 {
@@ -21,6 +22,7 @@ public:
     add_flag( "-z", ps.allow_zero_gain, "enable zero-gain refactoring" );
     add_flag( "-p,--progress", ps.progress, "show progress" );
     add_flag( "-v,--verbose", ps.verbose, "show statistics" );
+    set_in_place();
   }
 
   template<class Store>
@@ -36,14 +38,14 @@ public:
         auto* mig_p = static_cast<mockturtle::mig_network*>( store<Store>().current().get() );
         mockturtle::mig_npn_resynthesis resyn;
         mockturtle::refactoring( *mig_p, resyn, ps );
-        *mig_p = cleanup_dangling( *mig_p );
+        cirkit::cleanup_dangling_inplace( *mig_p );
       }
       else if constexpr ( std::is_same_v<Store, xmg_t> )
       {
         auto* xmg_p = static_cast<mockturtle::xmg_network*>( store<Store>().current().get() );
         mockturtle::xmg_npn_resynthesis resyn;
         mockturtle::refactoring( *xmg_p, resyn, ps );
-        *xmg_p = cleanup_dangling( *xmg_p );
+        cirkit::cleanup_dangling_inplace( *xmg_p );
       }
     }
     break;
@@ -54,14 +56,14 @@ public:
         auto* mig_p = static_cast<mockturtle::mig_network*>( store<Store>().current().get() );
         mockturtle::akers_resynthesis<mockturtle::mig_network> resyn;
         mockturtle::refactoring( *mig_p, resyn, ps );
-        *mig_p = cleanup_dangling( *mig_p );
+        cirkit::cleanup_dangling_inplace( *mig_p );
       }
       else if constexpr ( std::is_same_v<Store, xmg_t> )
       {
         auto* xmg_p = static_cast<mockturtle::xmg_network*>( store<Store>().current().get() );
         mockturtle::akers_resynthesis<mockturtle::xmg_network> resyn;
         mockturtle::refactoring( *xmg_p, resyn, ps );
-        *xmg_p = cleanup_dangling( *xmg_p );
+        cirkit::cleanup_dangling_inplace( *xmg_p );
       }
     }
     }
@@ -6,6 +6,7 @@
 #include <mockturtle/algorithms/mig_resub.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/cleanup_inplace.hpp"
 
 namespace alice
 {
@@ -23,6 +24,7 @@ public:
     // add_flag( "-z,--zero_gain", ps.zero_gain, "enable zero-gain resubstitution" );
     add_flag( "-p,--progress", ps.progress, "show progress" );
     add_flag( "-v,--verbose", ps.verbose, "show statistics" );
+    set_in_place();
   }
 
   template<class Store>
@@ -36,7 +38,7 @@ public:
       mockturtle::fanout_view<mockturtle::aig_network> fanout_view{*aig_p};
       view_t resub_view{fanout_view};
       mockturtle::aig_resubstitution( resub_view, ps, &st );
-      *aig_p = cleanup_dangling( *aig_p );
+      cirkit::cleanup_dangling_inplace( *aig_p );
     }
     else if constexpr ( std::is_same_v<Store, mig_t> )
     {
@@ -45,7 +47,7 @@ public:
       mockturtle::fanout_view<mockturtle::mig_network> fanout_view{*mig_p};
       view_t resub_view{fanout_view};
       mockturtle::mig_resubstitution( resub_view, ps, &st );
-      *mig_p = cleanup_dangling( *mig_p );
+      cirkit::cleanup_dangling_inplace( *mig_p );
     }
     else if constexpr ( std::is_same_v<Store, xag_t> )
     {
@@ -54,7 +56,7 @@ public:
       mockturtle::fanout_view<mockturtle::xag_network> fanout_view{*xag_p};
       view_t resub_view{fanout_view};
       mockturtle::resubstitution( resub_view, ps, &st );
-      *xag_p = cleanup_dangling( *xag_p );
+      cirkit::cleanup_dangling_inplace( *xag_p );
     }
     else if constexpr ( std::is_same_v<Store, xmg_t> )
     {
@@ -63,7 +65,7 @@ public:
       mockturtle::fanout_view<mockturtle::xmg_network> fanout_view{*xmg_p};
       view_t resub_view{fanout_view};
       mockturtle::resubstitution( resub_view, ps, &st );
-      *xmg_p = cleanup_dangling( *xmg_p );
+      cirkit::cleanup_dangling_inplace( *xmg_p );
     }
   }
 
@@ -1,11 +1,15 @@
 #include <alice/alice.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include <kitty/dynamic_truth_table.hpp>
 #include <mockturtle/algorithms/simulation.hpp>
 
 #include "../utils/cirkit_command.hpp"
+#include "../utils/pattern_simulation.hpp"
 
 namespace alice
 {
@@ -19,18 +23,29 @@ public:
     add_flag( "--binary", "print truth tables as binary strings" );
     add_flag( "--silent", "do not print truth tables" );
     add_flag( "--log", "keep simulation results in log" );
+    add_flag( "--words", "keep simulation results as 64-bit words (arrays in Python)" );
+    add_option( "--patterns", num_patterns, "simulate this number of patterns instead of exhaustive simulation" );
+    add_option( "--pattern_file", pattern_file, "simulate patterns from file, one string of 0 and 1 per line (first character for first input)" );
+    add_option( "--seed", seed, "random seed for patterns", true );
   }
 
   template<class Store>
   inline void execute_store()
   {
+    if ( is_set( "patterns" ) || is_set( "pattern_file" ) )
+    {
+      execute_patterns<Store>();
+      return;
+    }
+
     const auto& ntk = *( env->store<Store>().current() );
     const auto results = mockturtle::simulate<kitty::dynamic_truth_table>( ntk, mockturtle::default_simulator<kitty::dynamic_truth_table>( ntk.num_pis() ) );
 
     auto& tts = env->store<kitty::dynamic_truth_table>();
     tables.clear();
+    words = {};
 
-    if ( !is_set( "silent" ) || is_set( "store" ) || is_set( "log" ) )
+    if ( !is_set( "silent" ) || is_set( "store" ) || is_set( "log" ) || is_set( "words" ) )
     {
       for ( auto const& result : results )
       {
@@ -55,6 +70,11 @@ public:
         {
           tables.push_back( result );
         }
+        if ( is_set( "words" ) )
+        {
+          words.num_columns = result.num_blocks();
+          words.add_row( result );
+        }
       }
     }
   }
@@ -66,6 +86,11 @@ public:
       return nullptr;
     }
 
+    if ( is_set( "patterns" ) || is_set( "pattern_file" ) )
+    {
+      return {{"patterns", simulated_patterns}, {"signatures", signatures}};
+    }
+
     nlohmann::json j;
     for ( auto const& tt : tables )
     {
@@ -74,8 +99,103 @@ public:
     return {{"tables", j}};
   }
 
+  std::vector<std::pair<std::string, word_matrix>> log_words() const override
+  {
+    if ( !is_set( "words" ) )
+    {
+      return {};
+    }
+
+    return {{is_set( "patterns" ) || is_set( "pattern_file" ) ? "signatures" : "tables", words}};
+  }
+
+private:
+  /* bit-parallel simulation of random or given patterns; signatures are
+     printed in hexadecimal with the first pattern as least significant bit */
+  template<class Store>
+  void execute_patterns()
+  {
+    const auto& ntk = *( env->store<Store>().current() );
+
+    cirkit::pattern_set patterns( ntk.num_pis() );
+    if ( is_set( "pattern_file" ) )
+    {
+      try
+      {
+        patterns = cirkit::read_patterns( pattern_file, ntk.num_pis() );
+      }
+      catch ( std::string const& e )
+      {
+        env->err() << e << "\n";
+        return;
+      }
+    }
+    if ( is_set( "patterns" ) )
+    {
+      patterns.add_random_patterns( num_patterns, seed );
+    }
+    simulated_patterns = patterns.num_patterns;
+
+    if ( simulated_patterns == 0u )
+    {
+      env->err() << "[w] no patterns to simulate\n";
+      return;
+    }
+
+    const auto results = cirkit::simulate_patterns( ntk, patterns );
+
+    const auto store_results = is_set( "store" ) && ( simulated_patterns & ( simulated_patterns - 1u ) ) == 0u;
+    if ( is_set( "store" ) && !store_results )
+    {
+      env->err() << "[w] signatures are only stored for a power-of-two number of patterns\n";
+    }
+
+    auto& tts = env->store<kitty::dynamic_truth_table>();
+    signatures.clear();
+    words = {};
+    for ( auto const& result : results )
+    {
+      if ( is_set( "words" ) )
+      {
+        words.num_columns = result.size();
+        words.add_row( result );
+      }
+      if ( !is_set( "silent" ) || is_set( "log" ) )
+      {
+        const auto hex = cirkit::signature_to_hex( result, simulated_patterns );
+        if ( !is_set( "silent" ) )
+        {
+          std::cout << hex << "\n";
+        }
+        if ( is_set( "log" ) )
+        {
+          signatures.push_back( hex );
+        }
+      }
+      if ( store_results )
+      {
+        auto num_vars = 0u;
+        while ( ( 1u << num_vars ) < simulated_patterns )
+        {
+          ++num_vars;
+        }
+        kitty::dynamic_truth_table tt( num_vars );
+        std::copy_n( result.begin(), tt.num_blocks(), tt.begin() );
+        tts.extend();
+        tts.current() = tt;
+      }
+    }
+  }
+
 private:
   std::vector<kitty::dynamic_truth_table> tables;
+  word_matrix words;
+
+  uint32_t num_patterns{0u};
+  std::string pattern_file;
+  uint64_t seed{0xcafeaffe};
+  uint32_t simulated_patterns{0u};
+  std::vector<std::string> signatures;
 };
 
 ALICE_ADD_COMMAND( simulate, "Simulation" )
@@ -1,10 +1,13 @@
 #include <alice/alice.hpp>
 
+#include <algorithm>
 #include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
-#include <tweedledum/algorithms/simulation/classical_simulation.hpp>
+#include "../utils/classical_simulation.hpp"
 
 namespace alice
 {
@@ -14,7 +17,9 @@ class tofsim_command : public alice::command
 public:
   tofsim_command( const environment::ptr& env ) : command( env, "Toffoli gate simulation" )
   {
-    add_option( "--pattern,pattern", pattern, "input bit pattern" )->required();
+    add_option( "--pattern,pattern", pattern, "input bit pattern" );
+    add_option( "--pattern_file", pattern_file, "simulate all patterns in file, one per line" );
+    add_option( "--output", output, "write result patterns to file, one per line" );
     add_flag( "--quiet", "do not print result" );
   }
 
@@ -22,55 +27,84 @@ public:
   {
     return {
         has_store_element<qcircuit_t>( env ),
+        {[&]() { return is_set( "pattern" ) != is_set( "pattern_file" ); }, "either a pattern or a pattern file must be specified"},
         {[&]() { return std::count_if( pattern.begin(), pattern.end(), []( auto c ) { return c != '0' && c != '1'; } ) == 0; }, "input pattern must consists of only 0 and 1"},
-        {[&]() { return pattern.size() == store<qcircuit_t>().current().num_qubits(); }, "input pattern size must match number of qubits"}};
+        {[&]() { return !is_set( "pattern" ) || pattern.size() == store<qcircuit_t>().current().num_qubits(); }, "input pattern size must match number of qubits"}};
   }
 
   void execute() override
   {
-    const auto& circs = store<qcircuit_t>();
-    const auto result = tweedledum::simulate_pattern_classical( circs.current(), pattern_from_string() );
-    pattern_to_string( result );
-    if (!is_set("quiet")) {
-      std::cout << "[i] result: " << pattern_result << "\n";
+    const auto& circ = store<qcircuit_t>().current();
+    pattern_result.clear();
+    pattern_results.clear();
+
+    std::vector<cirkit::classical_gate> gates;
+    if ( !cirkit::classical_gates( circ, gates ) )
+    {
+      env->err() << "[e] circuit contains non-classical gates\n";
+      return;
     }
-  }
 
-  nlohmann::json log() const override
-  {
-    return {{"result", pattern_result}};
-  }
+    cirkit::pattern_set patterns;
+    try
+    {
+      patterns = is_set( "pattern_file" ) ? cirkit::read_qubit_patterns( pattern_file, circ.num_qubits() ) : cirkit::qubit_patterns_from_strings( {pattern}, circ.num_qubits() );
+    }
+    catch ( std::string const& e )
+    {
+      env->err() << e << "\n";
+      return;
+    }
 
-private:
-  uint64_t pattern_from_string() const
-  {
-    uint64_t ipattern{0};
-    const auto n = store<qcircuit_t>().current().num_qubits();
-    for ( auto i = 0; i < n; ++i )
+    cirkit::simulate_classical_gates( gates, patterns );
+
+    std::ofstream out;
+    if ( is_set( "output" ) )
     {
-      if ( pattern[i] == '1' )
+      out.open( output );
+      if ( !out.good() )
       {
-        ipattern |= ( 1 << ( n - 1 - i ) );
+        env->err() << "[e] could not open " << output << "\n";
+        return;
       }
     }
-    return ipattern;
-  }
 
-  void pattern_to_string( uint64_t opattern )
-  {
-    const auto n = store<qcircuit_t>().current().num_qubits();
-    pattern_result = std::string( n, '0' );
-    for ( auto i = 0; i < n; ++i )
+    for ( auto j = 0u; j < patterns.num_patterns; ++j )
     {
-      if ( ( opattern >> i ) & 1 )
+      const auto result = cirkit::qubit_pattern_to_string( patterns, j );
+      if ( is_set( "output" ) )
+      {
+        out << result << "\n";
+      }
+      else if ( is_set( "pattern_file" ) )
+      {
+        pattern_results.push_back( result );
+      }
+      else
+      {
+        pattern_result = result;
+      }
+
+      if ( !is_set( "quiet" ) && !is_set( "output" ) )
       {
-        pattern_result[n - 1 - i] = '1';
+        std::cout << "[i] result: " << result << "\n";
       }
     }
   }
 
+  nlohmann::json log() const override
+  {
+    if ( is_set( "pattern_file" ) )
+    {
+      return {{"results", pattern_results}};
+    }
+    return {{"result", pattern_result}};
+  }
+
 private:
   std::string pattern, pattern_result;
+  std::string pattern_file, output;
+  std::vector<std::string> pattern_results;
 };
 
 ALICE_ADD_COMMAND( tofsim, "Simulation" );
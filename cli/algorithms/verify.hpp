@@ -0,0 +1,167 @@
+#include <alice/alice.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "../utils/cirkit_command.hpp"
+#include "../utils/verify_circuit.hpp"
+
+namespace alice
+{
+
+class verify_command : public cirkit::cirkit_command<verify_command, perm_t, aig_t, mig_t, xag_t, xmg_t, klut_t>
+{
+public:
+  verify_command( environment::ptr& env ) : cirkit::cirkit_command<verify_command, perm_t, aig_t, mig_t, xag_t, xmg_t, klut_t>( env, "Verifies reversible circuit by exhaustive simulation", "verify against {0}" )
+  {
+    add_option( "--threads", num_threads, "number of threads (0 for number of cores)", true );
+    add_option( "--output_qubits", output_qubits, "qubit of each output, as logged by lns (default: match outputs against qubits)" );
+  }
+
+  rules validity_rules() const override
+  {
+    auto r = cirkit::cirkit_command<verify_command, perm_t, aig_t, mig_t, xag_t, xmg_t, klut_t>::validity_rules();
+    r.push_back( has_store_element<qcircuit_t>( env ) );
+    return r;
+  }
+
+  template<class Store>
+  inline void execute_store()
+  {
+    const auto& circ = store<qcircuit_t>().current();
+    result = {};
+    num_inputs = 0u;
+    reason.clear();
+
+    std::vector<cirkit::classical_gate> gates;
+    if ( !cirkit::classical_gates( circ, gates ) )
+    {
+      fail( "circuit contains non-classical gates" );
+      return;
+    }
+
+    const auto threads = num_threads == 0u ? std::max( std::thread::hardware_concurrency(), 1u ) : num_threads;
+
+    if constexpr ( std::is_same_v<Store, perm_t> )
+    {
+      const auto& perm = store<perm_t>().current();
+      num_inputs = circ.num_qubits();
+      if ( num_inputs >= 64u || perm.size() != ( uint64_t( 1u ) << num_inputs ) )
+      {
+        fail( fmt::format( "permutation of size {} does not match circuit with {} qubits", perm.size(), num_inputs ) );
+        return;
+      }
+      result = cirkit::verify_permutation( gates, num_inputs, perm, threads );
+    }
+    else
+    {
+      const auto& ntk = *( store<Store>().current() );
+      num_inputs = ntk.num_pis();
+      if ( num_inputs > circ.num_qubits() )
+      {
+        fail( fmt::format( "network has {} inputs, but circuit has only {} qubits", num_inputs, circ.num_qubits() ) );
+        return;
+      }
+      if ( num_inputs > max_inputs )
+      {
+        fail( fmt::format( "exhaustive simulation is limited to {} inputs", max_inputs ) );
+        return;
+      }
+      std::vector<uint32_t> qubits;
+      if ( is_set( "output_qubits" ) )
+      {
+        if ( output_qubits.size() != ntk.num_pos() )
+        {
+          fail( fmt::format( "{} output qubits given for network with {} outputs", output_qubits.size(), ntk.num_pos() ) );
+          return;
+        }
+        if ( std::any_of( output_qubits.begin(), output_qubits.end(), [&]( auto q ) { return q >= circ.num_qubits(); } ) )
+        {
+          fail( fmt::format( "output qubits must be less than {}", circ.num_qubits() ) );
+          return;
+        }
+        qubits.assign( output_qubits.begin(), output_qubits.end() );
+      }
+      result = cirkit::verify_logic_network( gates, circ.num_qubits(), ntk, threads, qubits );
+      if ( result.output_qubits.size() != ntk.num_pos() )
+      {
+        fail( fmt::format( "no qubit computes output {}", result.output_qubits.size() ) );
+        return;
+      }
+      for ( auto i = 0u; i < result.output_qubits.size(); ++i )
+      {
+        if ( result.complemented[i] )
+        {
+          env->out() << fmt::format( "[w] qubit {} computes complement of output {}\n", result.output_qubits[i], i );
+        }
+      }
+    }
+
+    if ( result.equivalent )
+    {
+      env->out() << "[i] circuit is equivalent\n";
+    }
+    else if ( result.counterexample )
+    {
+      env->out() << fmt::format( "[i] circuit is not equivalent, counterexample: {}\n", counterexample_string() );
+    }
+  }
+
+  nlohmann::json log() const override
+  {
+    nlohmann::json j{{"equivalent", result.equivalent}};
+    if ( !reason.empty() )
+    {
+      j["reason"] = reason;
+    }
+    if ( result.counterexample )
+    {
+      j["counterexample"] = counterexample_string();
+    }
+    if ( !result.output_qubits.empty() )
+    {
+      j["output_qubits"] = result.output_qubits;
+    }
+    return j;
+  }
+
+private:
+  void fail( std::string const& message )
+  {
+    reason = message;
+    env->err() << "[e] " << message << "\n";
+  }
+
+  /* input assignment with the last input first, as in tofsim patterns */
+  std::string counterexample_string() const
+  {
+    std::string s( num_inputs, '0' );
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      if ( ( *result.counterexample >> i ) & 1u )
+      {
+        s[num_inputs - 1u - i] = '1';
+      }
+    }
+    return s;
+  }
+
+private:
+  static constexpr uint32_t max_inputs = 32u;
+
+  unsigned num_threads{0u};
+  std::vector<unsigned> output_qubits;
+  std::string reason;
+  uint32_t num_inputs{0u};
+  cirkit::circuit_verification_result result;
+};
+
+ALICE_ADD_COMMAND( verify, "Verification" )
+
+} // namespace alice
@@ -12,6 +12,7 @@
 #include "stores/xag.hpp"
 #include "stores/xmg.hpp"
 
+#include "algorithms/cec.hpp"
 #include "algorithms/collapse_mapping.hpp"
 #include "algorithms/cut_rewrite.hpp"
 #include "algorithms/exact.hpp"
@@ -19,6 +20,7 @@
 #include "algorithms/migcost.hpp"
 #include "algorithms/mighty.hpp"
 #include "algorithms/minmc.hpp"
+#include "algorithms/portfolio.hpp"
 #include "algorithms/lut_resynthesis.hpp"
 #include "algorithms/print_gates.hpp"
 #include "algorithms/refactor.hpp"
@@ -2,7 +2,7 @@
 
 namespace alice
 {
-ALICE_ADD_FILE_TYPE_READ_ONLY( aiger, "Aiger" );
+ALICE_ADD_FILE_TYPE( aiger, "Aiger" );
 ALICE_ADD_FILE_TYPE( bench, "BENCH" );
 ALICE_ADD_FILE_TYPE( verilog, "Verilog" );
 }
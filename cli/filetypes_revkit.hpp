@@ -9,7 +9,7 @@ ALICE_ADD_FILE_TYPE_WRITE_ONLY( qasm, "QASM" );
 ALICE_ADD_FILE_TYPE( quil, "Quil" );
 ALICE_ADD_FILE_TYPE_WRITE_ONLY( quirk, "Quirk" );
 
-ALICE_ADD_FILE_TYPE_READ_ONLY( aiger, "Aiger" );
+ALICE_ADD_FILE_TYPE( aiger, "Aiger" );
 ALICE_ADD_FILE_TYPE( bench, "BENCH" );
 ALICE_ADD_FILE_TYPE( verilog, "Verilog" );
 }
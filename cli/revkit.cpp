@@ -26,5 +26,6 @@
 #include "algorithms/tbs.hpp"
 #include "algorithms/tofsim.hpp"
 #include "algorithms/tt.hpp"
+#include "algorithms/verify.hpp"
 
 ALICE_MAIN( revkit )
@@ -6,15 +6,20 @@
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_verilog.hpp>
 #include <mockturtle/networks/aig.hpp>
-#include <mockturtle/views/depth_view.hpp>
 #include <mockturtle/views/mapping_view.hpp>
 
 #include <fmt/format.h>
 
+#include "../utils/read_aiger.hpp"
+#include "../utils/flat_network.hpp"
+#include "../utils/serialize_network.hpp"
+#include "../utils/statistics_view.hpp"
+#include "../utils/write_aiger.hpp"
+
 namespace alice
 {
 
-using aig_nt = mockturtle::mapping_view<mockturtle::aig_network, true>;
+using aig_nt = cirkit::statistics_view<mockturtle::aig_network>;
 using aig_t = std::shared_ptr<aig_nt>;
 
 ALICE_ADD_STORE( aig_t, "aig", "a", "AIG", "AIGs" );
@@ -26,8 +31,7 @@ ALICE_DESCRIBE_STORE( aig_t, aig )
 
 ALICE_PRINT_STORE_STATISTICS( aig_t, os, aig )
 {
-  mockturtle::depth_view depth_aig{*aig};
-  os << fmt::format( "AIG   i/o = {}/{}   gates = {}   level = {}", aig->num_pis(), aig->num_pos(), aig->num_gates(), depth_aig.depth() );
+  os << fmt::format( "AIG   i/o = {}/{}   gates = {}   level = {}", aig->num_pis(), aig->num_pos(), aig->num_gates(), aig->statistics().depth );
   if ( aig->has_mapping() )
   {
     os << fmt::format( "   luts = {}", aig->num_cells() );
@@ -37,22 +41,63 @@ ALICE_PRINT_STORE_STATISTICS( aig_t, os, aig )
 
 ALICE_LOG_STORE_STATISTICS( aig_t, aig )
 {
-  mockturtle::depth_view depth_aig{*aig};
   return {
     {"pis", aig->num_pis()},
     {"pos", aig->num_pos()},
     {"gates", aig->num_gates()},
-    {"depth", depth_aig.depth()}
+    {"depth", aig->statistics().depth}
   };
 }
 
-ALICE_READ_FILE( aig_t, aiger, filename, cmd )
+ALICE_SERIALIZE_STORE( aig_t, aig, out )
+{
+  cirkit::serialize_network( *aig, out );
+}
+
+ALICE_DESERIALIZE_STORE( aig_t, in )
+{
+  return cirkit::deserialize_network<mockturtle::aig_network>( in );
+}
+
+ALICE_EXPORT_FLAT_NETWORK( aig_t, aig, flat )
+{
+  cirkit::to_flat_network( *aig, flat );
+}
+
+ALICE_IMPORT_FLAT_NETWORK( aig_t, network )
+{
+  return cirkit::from_flat_network<mockturtle::aig_network>( network );
+}
+
+template<>
+inline bool can_read<aig_t, io_aiger_tag_t>( command& cmd )
+{
+  cmd.add_flag( "--mmap", "decode binary AIGER directly from a memory-mapped file (AIG only)" );
+  return true;
+}
+
+template<>
+inline aig_t read<aig_t, io_aiger_tag_t>( const std::string& filename, const command& cmd )
 {
   mockturtle::aig_network aig;
-  lorina::read_aiger( filename, mockturtle::aiger_reader( aig ) );
+  if ( !cmd.is_set( "mmap" ) || !cirkit::read_aiger_mapped( filename, aig ) )
+  {
+    lorina::read_aiger( filename, mockturtle::aiger_reader( aig ) );
+  }
   return std::make_shared<aig_nt>( aig );
 }
 
+ALICE_WRITE_FILE( aig_t, aiger, aig, filename, cmd )
+{
+  cirkit::write_aiger( *aig, filename );
+}
+
+template<>
+inline void write<aig_t, io_aiger_tag_t>( aig_t const& aig, std::ostream& os, const command& )
+{
+  cirkit::write_aiger( *aig, os, true );
+}
+
 ALICE_WRITE_FILE( aig_t, bench, aig, filename, cmd )
 {
   mockturtle::write_bench( *aig, filename );
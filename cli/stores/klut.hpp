@@ -7,15 +7,18 @@
 #include <mockturtle/io/bench_reader.hpp>
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/networks/klut.hpp>
-#include <mockturtle/views/depth_view.hpp>
 #include <mockturtle/views/mapping_view.hpp>
 
 #include <fmt/format.h>
 
+#include "../utils/flat_network.hpp"
+#include "../utils/serialize_network.hpp"
+#include "../utils/statistics_view.hpp"
+
 namespace alice
 {
 
-using klut_nt = mockturtle::mapping_view<mockturtle::klut_network, true>;
+using klut_nt = cirkit::statistics_view<mockturtle::klut_network>;
 using klut_t = std::shared_ptr<klut_nt>;
 
 ALICE_ADD_STORE( klut_t, "lut", "l", "LUT network", "LUT networks" );
@@ -27,8 +30,7 @@ ALICE_DESCRIBE_STORE( klut_t, klut )
 
 ALICE_PRINT_STORE_STATISTICS( klut_t, os, klut )
 {
-  mockturtle::depth_view depth_klut{*klut};
-  os << fmt::format( "LUT network   i/o = {}/{}   gates = {}   level = {}", klut->num_pis(), klut->num_pos(), klut->num_gates(), depth_klut.depth() );
+  os << fmt::format( "LUT network   i/o = {}/{}   gates = {}   level = {}", klut->num_pis(), klut->num_pos(), klut->num_gates(), klut->statistics().depth );
   if ( klut->has_mapping() )
   {
     os << fmt::format( "   luts = {}", klut->num_cells() );
@@ -38,15 +40,34 @@ ALICE_PRINT_STORE_STATISTICS( klut_t, os, klut )
 
 ALICE_LOG_STORE_STATISTICS( klut_t, klut )
 {
-  mockturtle::depth_view depth_klut{*klut};
   return {
     {"pis", klut->num_pis()},
     {"pos", klut->num_pos()},
     {"gates", klut->num_gates()},
-    {"depth", depth_klut.depth()}
+    {"depth", klut->statistics().depth}
   };
 }
 
+ALICE_SERIALIZE_STORE( klut_t, klut, out )
+{
+  cirkit::serialize_network( *klut, out );
+}
+
+ALICE_DESERIALIZE_STORE( klut_t, in )
+{
+  return cirkit::deserialize_network<mockturtle::klut_network>( in );
+}
+
+ALICE_EXPORT_FLAT_NETWORK( klut_t, klut, flat )
+{
+  cirkit::to_flat_network( *klut, flat );
+}
+
+ALICE_IMPORT_FLAT_NETWORK( klut_t, network )
+{
+  return cirkit::from_flat_network<mockturtle::klut_network>( network );
+}
+
 ALICE_READ_FILE( klut_t, aiger, filename, cmd )
 {
   mockturtle::klut_network klut;
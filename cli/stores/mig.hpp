@@ -8,15 +8,19 @@
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_verilog.hpp>
 #include <mockturtle/networks/mig.hpp>
-#include <mockturtle/views/depth_view.hpp>
 #include <mockturtle/views/mapping_view.hpp>
 
 #include <fmt/format.h>
 
+#include "../utils/flat_network.hpp"
+#include "../utils/serialize_network.hpp"
+#include "../utils/statistics_view.hpp"
+#include "../utils/write_aiger.hpp"
+
 namespace alice
 {
 
-using mig_nt = mockturtle::mapping_view<mockturtle::mig_network, true>;
+using mig_nt = cirkit::statistics_view<mockturtle::mig_network>;
 using mig_t = std::shared_ptr<mig_nt>;
 
 ALICE_ADD_STORE( mig_t, "mig", "m", "MIG", "MIGs" );
@@ -28,8 +32,7 @@ ALICE_DESCRIBE_STORE( mig_t, mig )
 
 ALICE_PRINT_STORE_STATISTICS( mig_t, os, mig )
 {
-  mockturtle::depth_view depth_mig{*mig};
-  os << fmt::format( "MIG   i/o = {}/{}   gates = {}   level = {}", mig->num_pis(), mig->num_pos(), mig->num_gates(), depth_mig.depth() );
+  os << fmt::format( "MIG   i/o = {}/{}   gates = {}   level = {}", mig->num_pis(), mig->num_pos(), mig->num_gates(), mig->statistics().depth );
   if ( mig->has_mapping() )
   {
     os << fmt::format( "   luts = {}", mig->num_cells() );
@@ -39,15 +42,34 @@ ALICE_PRINT_STORE_STATISTICS( mig_t, os, mig )
 
 ALICE_LOG_STORE_STATISTICS( mig_t, mig )
 {
-  mockturtle::depth_view depth_mig{*mig};
   return {
     {"pis", mig->num_pis()},
     {"pos", mig->num_pos()},
     {"gates", mig->num_gates()},
-    {"depth", depth_mig.depth()}
+    {"depth", mig->statistics().depth}
   };
 }
 
+ALICE_SERIALIZE_STORE( mig_t, mig, out )
+{
+  cirkit::serialize_network( *mig, out );
+}
+
+ALICE_DESERIALIZE_STORE( mig_t, in )
+{
+  return cirkit::deserialize_network<mockturtle::mig_network>( in );
+}
+
+ALICE_EXPORT_FLAT_NETWORK( mig_t, mig, flat )
+{
+  cirkit::to_flat_network( *mig, flat );
+}
+
+ALICE_IMPORT_FLAT_NETWORK( mig_t, network )
+{
+  return cirkit::from_flat_network<mockturtle::mig_network>( network );
+}
+
 ALICE_READ_FILE( mig_t, aiger, filename, cmd )
 {
   mockturtle::mig_network mig;
@@ -60,6 +82,17 @@ ALICE_READ_FILE( mig_t, aiger, filename, cmd )
   return std::make_shared<mig_nt>( mig );
 }
 
+ALICE_WRITE_FILE( mig_t, aiger, mig, filename, cmd )
+{
+  cirkit::write_aiger( *mig, filename );
+}
+
+template<>
+inline void write<mig_t, io_aiger_tag_t>( mig_t const& mig, std::ostream& os, const command& )
+{
+  cirkit::write_aiger( *mig, os, true );
+}
+
 ALICE_WRITE_FILE( mig_t, bench, mig, filename, cmd )
 {
   mockturtle::write_bench( *mig, filename );
@@ -2,6 +2,8 @@
 
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <string>
 #include <vector>
 
 #include <fmt/format.h>
@@ -18,4 +20,22 @@ ALICE_DESCRIBE_STORE( perm_t, perm )
   return fmt::format( "{} qubits", static_cast<uint32_t>( std::log2( perm.size() ) ) );
 }
 
+ALICE_SERIALIZE_STORE( perm_t, perm, out )
+{
+  out.write<uint64_t>( perm.size() );
+  out.write_bytes( reinterpret_cast<const char*>( perm.data() ), perm.size() * sizeof( uint16_t ) );
+}
+
+ALICE_DESERIALIZE_STORE( perm_t, in )
+{
+  const auto size = in.read<uint64_t>();
+  if ( size > in.remaining() / sizeof( uint16_t ) )
+  {
+    throw std::string( "[e] malformed permutation in session file" );
+  }
+  perm_t perm( size );
+  std::memcpy( perm.data(), in.take( size * sizeof( uint16_t ) ), size * sizeof( uint16_t ) );
+  return perm;
+}
+
 }
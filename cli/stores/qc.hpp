@@ -1,7 +1,12 @@
 #include <alice/alice.hpp>
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <fmt/format.h>
 
+#include <tweedledum/gates/gate_kinds.hpp>
 #include <tweedledum/gates/mcmt_gate.hpp>
 #include <tweedledum/io/print.hpp>
 #include <tweedledum/io/quil.hpp>
@@ -38,6 +43,77 @@ ALICE_LOG_STORE_STATISTICS( qcircuit_t, circ )
       {"gates", circ.num_gates()}};
 }
 
+ALICE_SERIALIZE_STORE( qcircuit_t, circ, out )
+{
+  out.write<uint32_t>( circ.num_qubits() );
+  out.write<uint32_t>( circ.num_gates() );
+
+  std::vector<uint32_t> controls, targets;
+  circ.foreach_cgate( [&]( auto const& node ) {
+    auto const& gate = node.gate;
+    controls.clear();
+    targets.clear();
+    gate.foreach_control( [&]( auto q ) { controls.push_back( static_cast<uint32_t>( q ) ); } );
+    gate.foreach_target( [&]( auto q ) { targets.push_back( static_cast<uint32_t>( q ) ); } );
+
+    out.write<uint32_t>( static_cast<uint32_t>( gate.kind() ) );
+    out.write<float>( static_cast<float>( gate.rotation_angle() ) );
+    out.write<uint32_t>( static_cast<uint32_t>( controls.size() ) );
+    for ( auto q : controls )
+    {
+      out.write<uint32_t>( q );
+    }
+    out.write<uint32_t>( static_cast<uint32_t>( targets.size() ) );
+    for ( auto q : targets )
+    {
+      out.write<uint32_t>( q );
+    }
+  } );
+}
+
+ALICE_DESERIALIZE_STORE( qcircuit_t, in )
+{
+  const auto malformed = []() {
+    return std::string( "[e] malformed quantum circuit in session file" );
+  };
+
+  qcircuit_t circ;
+  const auto num_qubits = in.read<uint32_t>();
+  for ( auto i = 0u; i < num_qubits; ++i )
+  {
+    circ.add_qubit();
+  }
+
+  const auto read_qubits = [&]( std::vector<uint32_t>& qubits ) {
+    const auto size = in.read<uint32_t>();
+    if ( size > num_qubits )
+    {
+      throw malformed();
+    }
+    qubits.resize( size );
+    for ( auto& q : qubits )
+    {
+      q = in.read<uint32_t>();
+      if ( q >= num_qubits )
+      {
+        throw malformed();
+      }
+    }
+  };
+
+  const auto num_gates = in.read<uint32_t>();
+  std::vector<uint32_t> controls, targets;
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto kind = static_cast<tweedledum::gate_kinds_t>( in.read<uint32_t>() );
+    const auto angle = in.read<float>();
+    read_qubits( controls );
+    read_qubits( targets );
+    circ.add_gate( kind, controls, targets, angle );
+  }
+  return circ;
+}
+
 ALICE_WRITE_FILE( qcircuit_t, cirq, circ, filename, cmd )
 {
   write_cirq( circ, filename );
@@ -1,5 +1,8 @@
 #include <alice/alice.hpp>
 
+#include <cstdint>
+#include <string>
+
 #include <kitty/dynamic_truth_table.hpp>
 #include <kitty/print.hpp>
 
@@ -27,6 +30,40 @@ ALICE_LOG_STORE_STATISTICS( kitty::dynamic_truth_table, tt )
   };
 }
 
+ALICE_SERIALIZE_STORE( kitty::dynamic_truth_table, tt, out )
+{
+  out.write<uint32_t>( tt.num_vars() );
+  for ( auto word : tt )
+  {
+    out.write<uint64_t>( word );
+  }
+}
+
+ALICE_DESERIALIZE_STORE( kitty::dynamic_truth_table, in )
+{
+  const auto num_vars = in.read<uint32_t>();
+  /* check the number of words against the file before allocating the table */
+  const auto num_blocks = num_vars <= 6u ? uint64_t( 1u ) : uint64_t( 1u ) << ( num_vars - 6u );
+  if ( num_vars > 32u || num_blocks > in.remaining() / sizeof( uint64_t ) )
+  {
+    throw std::string( "[e] malformed truth table in session file" );
+  }
+  kitty::dynamic_truth_table tt( num_vars );
+  for ( auto& word : tt )
+  {
+    word = in.read<uint64_t>();
+  }
+  return tt;
+}
+
+ALICE_EXPORT_WORDS( kitty::dynamic_truth_table, tt )
+{
+  word_matrix words;
+  words.num_columns = tt.num_blocks();
+  words.add_row( tt );
+  return words;
+}
+
 ALICE_PRINT_STORE( kitty::dynamic_truth_table, os, tt )
 {
   kitty::print_hex( tt, os );
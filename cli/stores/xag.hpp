@@ -6,15 +6,19 @@
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_verilog.hpp>
 #include <mockturtle/networks/xag.hpp>
-#include <mockturtle/views/depth_view.hpp>
 #include <mockturtle/views/mapping_view.hpp>
 
 #include <fmt/format.h>
 
+#include "../utils/flat_network.hpp"
+#include "../utils/serialize_network.hpp"
+#include "../utils/statistics_view.hpp"
+#include "../utils/write_aiger.hpp"
+
 namespace alice
 {
 
-using xag_nt = mockturtle::mapping_view<mockturtle::xag_network, true>;
+using xag_nt = cirkit::statistics_view<mockturtle::xag_network>;
 using xag_t = std::shared_ptr<xag_nt>;
 
 ALICE_ADD_STORE( xag_t, "xag", "", "XAG", "XAGs" );
@@ -26,8 +30,7 @@ ALICE_DESCRIBE_STORE( xag_t, xag )
 
 ALICE_PRINT_STORE_STATISTICS( xag_t, os, xag )
 {
-  mockturtle::depth_view depth_xag{*xag};
-  os << fmt::format( "XAG   i/o = {}/{}   gates = {}   level = {}", xag->num_pis(), xag->num_pos(), xag->num_gates(), depth_xag.depth() );
+  os << fmt::format( "XAG   i/o = {}/{}   gates = {}   level = {}", xag->num_pis(), xag->num_pos(), xag->num_gates(), xag->statistics().depth );
   if ( xag->has_mapping() )
   {
     os << fmt::format( "   luts = {}", xag->num_cells() );
@@ -37,15 +40,36 @@ ALICE_PRINT_STORE_STATISTICS( xag_t, os, xag )
 
 ALICE_LOG_STORE_STATISTICS( xag_t, xag )
 {
-  mockturtle::depth_view depth_xag{*xag};
   return {
     {"pis", xag->num_pis()},
     {"pos", xag->num_pos()},
     {"gates", xag->num_gates()},
-    {"depth", depth_xag.depth()}
+    {"and", xag->statistics().num_and},
+    {"xor", xag->statistics().num_xor},
+    {"depth", xag->statistics().depth}
   };
 }
 
+ALICE_SERIALIZE_STORE( xag_t, xag, out )
+{
+  cirkit::serialize_network( *xag, out );
+}
+
+ALICE_DESERIALIZE_STORE( xag_t, in )
+{
+  return cirkit::deserialize_network<mockturtle::xag_network>( in );
+}
+
+ALICE_EXPORT_FLAT_NETWORK( xag_t, xag, flat )
+{
+  cirkit::to_flat_network( *xag, flat );
+}
+
+ALICE_IMPORT_FLAT_NETWORK( xag_t, network )
+{
+  return cirkit::from_flat_network<mockturtle::xag_network>( network );
+}
+
 ALICE_READ_FILE( xag_t, aiger, filename, cmd )
 {
   mockturtle::xag_network xag;
@@ -53,6 +77,17 @@ ALICE_READ_FILE( xag_t, aiger, filename, cmd )
   return std::make_shared<xag_nt>( xag );
 }
 
+ALICE_WRITE_FILE( xag_t, aiger, xag, filename, cmd )
+{
+  cirkit::write_aiger( *xag, filename );
+}
+
+template<>
+inline void write<xag_t, io_aiger_tag_t>( xag_t const& xag, std::ostream& os, const command& )
+{
+  cirkit::write_aiger( *xag, os, true );
+}
+
 ALICE_WRITE_FILE( xag_t, bench, xag, filename, cmd )
 {
   mockturtle::write_bench( *xag, filename );
@@ -8,15 +8,19 @@
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_verilog.hpp>
 #include <mockturtle/networks/xmg.hpp>
-#include <mockturtle/views/depth_view.hpp>
 #include <mockturtle/views/mapping_view.hpp>
 
 #include <fmt/format.h>
 
+#include "../utils/flat_network.hpp"
+#include "../utils/serialize_network.hpp"
+#include "../utils/statistics_view.hpp"
+#include "../utils/write_aiger.hpp"
+
 namespace alice
 {
 
-using xmg_nt = mockturtle::mapping_view<mockturtle::xmg_network, true>;
+using xmg_nt = cirkit::statistics_view<mockturtle::xmg_network>;
 using xmg_t = std::shared_ptr<xmg_nt>;
 
 ALICE_ADD_STORE( xmg_t, "xmg", "x", "XMG", "XMGs" );
@@ -28,8 +32,7 @@ ALICE_DESCRIBE_STORE( xmg_t, xmg )
 
 ALICE_PRINT_STORE_STATISTICS( xmg_t, os, xmg )
 {
-  mockturtle::depth_view depth_xmg{*xmg};
-  os << fmt::format( "XMG   i/o = {}/{}   gates = {}   level = {}", xmg->num_pis(), xmg->num_pos(), xmg->num_gates(), depth_xmg.depth() );
+  os << fmt::format( "XMG   i/o = {}/{}   gates = {}   level = {}", xmg->num_pis(), xmg->num_pos(), xmg->num_gates(), xmg->statistics().depth );
   if ( xmg->has_mapping() )
   {
     os << fmt::format( "   luts = {}", xmg->num_cells() );
@@ -39,15 +42,36 @@ ALICE_PRINT_STORE_STATISTICS( xmg_t, os, xmg )
 
 ALICE_LOG_STORE_STATISTICS( xmg_t, xmg )
 {
-  mockturtle::depth_view depth_xmg{*xmg};
   return {
     {"pis", xmg->num_pis()},
     {"pos", xmg->num_pos()},
     {"gates", xmg->num_gates()},
-    {"depth", depth_xmg.depth()}
+    {"maj", xmg->statistics().num_maj},
+    {"xor3", xmg->statistics().num_xor3},
+    {"depth", xmg->statistics().depth}
   };
 }
 
+ALICE_SERIALIZE_STORE( xmg_t, xmg, out )
+{
+  cirkit::serialize_network( *xmg, out );
+}
+
+ALICE_DESERIALIZE_STORE( xmg_t, in )
+{
+  return cirkit::deserialize_network<mockturtle::xmg_network>( in );
+}
+
+ALICE_EXPORT_FLAT_NETWORK( xmg_t, xmg, flat )
+{
+  cirkit::to_flat_network( *xmg, flat );
+}
+
+ALICE_IMPORT_FLAT_NETWORK( xmg_t, network )
+{
+  return cirkit::from_flat_network<mockturtle::xmg_network>( network );
+}
+
 ALICE_READ_FILE( xmg_t, aiger, filename, cmd )
 {
   mockturtle::xmg_network xmg;
@@ -60,6 +84,17 @@ ALICE_READ_FILE( xmg_t, aiger, filename, cmd )
   return std::make_shared<xmg_nt>( xmg );
 }
 
+ALICE_WRITE_FILE( xmg_t, aiger, xmg, filename, cmd )
+{
+  cirkit::write_aiger( *xmg, filename );
+}
+
+template<>
+inline void write<xmg_t, io_aiger_tag_t>( xmg_t const& xmg, std::ostream& os, const command& )
+{
+  cirkit::write_aiger( *xmg, os, true );
+}
+
 ALICE_WRITE_FILE( xmg_t, bench, xmg, filename, cmd )
 {
   mockturtle::write_bench( *xmg, filename );
@@ -1,14 +1,39 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <type_traits>
+
 #include <alice/command.hpp>
 
 #include <fmt/format.h>
 
+#include "equivalence_checking.hpp"
+#include "statistics_view.hpp"
+
 namespace cirkit
 {
 
 using namespace alice;
 
+namespace detail
+{
+
+/* network type of stores of statistics views, void for other stores */
+template<class S>
+struct store_network
+{
+  using type = void;
+};
+
+template<class Ntk>
+struct store_network<std::shared_ptr<statistics_view<Ntk>>>
+{
+  using type = Ntk;
+};
+
+} // namespace detail
+
 template<class Command, class... Stores>
 class cirkit_command : public command
 {
@@ -62,6 +87,18 @@ protected:
     }
   }
 
+  /* Declares that the command modifies the current store element in place.
+     If the element is shared, e.g., with the undo history, the command works
+     on a copy (copy-on-write).  If the environment variable verify_after is
+     set to 1, the modified network is checked for equivalence against the
+     original one, which is restored if the check fails.  If the check is
+     undecided within its conflict limits, the modified network is kept with
+     a warning. */
+  void set_in_place()
+  {
+    in_place = true;
+  }
+
 private:
   template<class S>
   void add_flag_helper( const std::string& option_text )
@@ -88,7 +125,8 @@ private:
 
     if ( is_set( option ) || default_option == option || env->default_option() == option )
     {
-      static_cast<Command*>( this )->template execute_store<S>();
+      execute_and_verify<S>();
+      ( invalidate_current_statistics<Stores>(), ... );
       env->set_default_option( option );
       return true;
     }
@@ -96,8 +134,77 @@ private:
     return false;
   }
 
+  template<class S>
+  void execute_and_verify()
+  {
+    using Ntk = typename detail::store_network<S>::type;
+    if constexpr ( !std::is_same_v<Ntk, void> )
+    {
+      if ( in_place && !store<S>().empty() )
+      {
+        const auto verify = Ntk::max_fanin_size <= 3 && env->variable( "verify_after" ) == "1";
+        if ( verify || store<S>().current().use_count() > 1 )
+        {
+          const auto original = store<S>().current();
+          store<S>().current() = std::make_shared<typename S::element_type>( Ntk( std::make_shared<typename Ntk::storage::element_type>( *original->_storage ) ) );
+
+          static_cast<Command*>( this )->template execute_store<S>();
+
+          if ( verify && !verify_in_place( *original, *store<S>().current() ) )
+          {
+            store<S>().current() = original;
+          }
+          return;
+        }
+      }
+    }
+
+    static_cast<Command*>( this )->template execute_store<S>();
+  }
+
+  template<class Ntk>
+  bool verify_in_place( Ntk const& original, Ntk const& optimized )
+  {
+    if constexpr ( Ntk::max_fanin_size <= 3 )
+    {
+      if ( optimized.num_pis() != original.num_pis() || optimized.num_pos() != original.num_pos() )
+      {
+        env->err() << "[e] verification failed, interface has changed, restoring network\n";
+        return false;
+      }
+
+      const auto result = equivalence_checking( original, optimized );
+      if ( result.undecided )
+      {
+        env->err() << fmt::format( "[w] verification undecided, output {} could not be proved within the conflict limit, keeping network\n", result.output );
+        return true;
+      }
+      if ( !result.equivalent )
+      {
+        std::string pattern( result.counterexample.size(), '0' );
+        for ( auto i = 0u; i < pattern.size(); ++i )
+        {
+          pattern[i] = result.counterexample[i] ? '1' : '0';
+        }
+        env->err() << fmt::format( "[e] verification failed, output {} differs for input {}, restoring network\n", result.output, pattern );
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<class S>
+  void invalidate_current_statistics()
+  {
+    if ( !store<S>().empty() )
+    {
+      invalidate_statistics( store<S>().current() );
+    }
+  }
+
 private:
   std::string default_option;
+  bool in_place{false};
 };
 
 } // namespace cirkit
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tweedledum/gates/gate_kinds.hpp>
+
+#include "pattern_simulation.hpp"
+
+namespace cirkit
+{
+
+/* Classical reversible gate that inverts its targets if all controls are 1 */
+struct classical_gate
+{
+  std::vector<uint32_t> controls;
+  std::vector<uint32_t> targets;
+};
+
+/* Extracts the classical gates of a quantum circuit
+ *
+ * Returns false if the circuit contains a gate that is not a NOT, CNOT, or
+ * multiple-controlled Toffoli gate.
+ */
+template<class Circuit>
+bool classical_gates( Circuit const& circ, std::vector<classical_gate>& gates )
+{
+  gates.clear();
+  bool classical{true};
+  circ.foreach_cgate( [&]( auto const& node ) {
+    auto const& gate = node.gate;
+    switch ( gate.kind() )
+    {
+    case tweedledum::gate_kinds_t::pauli_x:
+    case tweedledum::gate_kinds_t::cx:
+    case tweedledum::gate_kinds_t::mcx:
+    {
+      classical_gate g;
+      gate.foreach_control( [&]( auto q ) { g.controls.push_back( static_cast<uint32_t>( q ) ); } );
+      gate.foreach_target( [&]( auto q ) { g.targets.push_back( static_cast<uint32_t>( q ) ); } );
+      gates.push_back( g );
+    }
+    break;
+    default:
+      classical = false;
+      break;
+    }
+  } );
+  return classical;
+}
+
+/* Patterns over qubits are stored as pattern set in which input q is qubit
+ * q.  Pattern strings are given with the most significant qubit first, i.e.,
+ * character i belongs to qubit n - 1 - i.
+ */
+inline pattern_set qubit_patterns_from_strings( std::vector<std::string> const& patterns, uint32_t num_qubits )
+{
+  pattern_set result( num_qubits );
+  for ( auto const& pattern : patterns )
+  {
+    result.add_pattern( pattern );
+  }
+  std::reverse( result.words.begin(), result.words.end() );
+  return result;
+}
+
+inline pattern_set read_qubit_patterns( std::string const& filename, uint32_t num_qubits )
+{
+  auto result = read_patterns( filename, num_qubits );
+  std::reverse( result.words.begin(), result.words.end() );
+  return result;
+}
+
+inline std::string qubit_pattern_to_string( pattern_set const& patterns, uint32_t j )
+{
+  const auto n = static_cast<uint32_t>( patterns.words.size() );
+  std::string result( n, '0' );
+  for ( auto q = 0u; q < n; ++q )
+  {
+    if ( ( patterns.words[q][j / 64u] >> ( j % 64u ) ) & 1u )
+    {
+      result[n - 1u - q] = '1';
+    }
+  }
+  return result;
+}
+
+/* Simulates classical gates on all patterns in place
+ *
+ * The patterns are processed in blocks of words, and each gate is applied
+ * to all words of a block before the next gate, such that the block stays in
+ * cache and the word loops can be vectorized.
+ */
+inline void simulate_classical_gates( std::vector<classical_gate> const& gates, pattern_set& patterns, uint32_t block_words = 64u )
+{
+  const auto num_words = patterns.num_words();
+  std::vector<uint64_t> condition( block_words );
+
+  for ( auto offset = 0u; offset < num_words; offset += block_words )
+  {
+    const auto size = std::min( block_words, num_words - offset );
+
+    for ( auto const& gate : gates )
+    {
+      std::fill_n( condition.begin(), size, ~uint64_t( 0u ) );
+      for ( auto c : gate.controls )
+      {
+        const auto* v = &patterns.words[c][offset];
+        for ( auto k = 0u; k < size; ++k )
+        {
+          condition[k] &= v[k];
+        }
+      }
+      for ( auto t : gate.targets )
+      {
+        auto* v = &patterns.words[t][offset];
+        for ( auto k = 0u; k < size; ++k )
+        {
+          v[k] ^= condition[k];
+        }
+      }
+    }
+  }
+
+  /* clear the unused bits of the last word */
+  if ( patterns.num_patterns % 64u != 0u )
+  {
+    const auto mask = ( uint64_t( 1u ) << ( patterns.num_patterns % 64u ) ) - 1u;
+    for ( auto& w : patterns.words )
+    {
+      w.back() &= mask;
+    }
+  }
+}
+
+} // namespace cirkit
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cirkit
+{
+
+/* Removes dangling nodes from a network without copying it
+ *
+ * Same result as `ntk = cleanup_dangling( ntk )` up to structural hashing:
+ * constants and primary inputs are kept, gates in the transitive fanin of
+ * the outputs are renumbered in depth-first topological order, and all other
+ * gates are removed.  Instead of building a second network, the routine
+ * permutes the node vector of the storage in place, such that the only extra
+ * memory is one 32-bit word and one bit per node, a traversal stack, and the
+ * structural hash table, which is rebuilt.  The capacity of the node vector
+ * is not released, since later passes grow the network again.
+ *
+ * Gates with at most three fanins are stored with ordered fanins, in which
+ * the direction of the order distinguishes gate types (e.g., AND and XOR in
+ * XAGs).  Their fanins are sorted again after renumbering, preserving the
+ * direction.  Fanins of LUT networks keep their order.  Gates that have
+ * become structurally equal are not merged.
+ */
+template<class Ntk>
+void cleanup_dangling_inplace( Ntk& ntk )
+{
+  auto& storage = *ntk._storage;
+  auto& nodes = storage.nodes;
+  const auto num_nodes = static_cast<uint32_t>( nodes.size() );
+
+  constexpr auto unvisited = UINT32_MAX;
+  std::vector<uint32_t> index( num_nodes, unvisited );
+  std::vector<bool> expanded( num_nodes, false );
+
+  /* constants and primary inputs keep their positions in front */
+  uint32_t next{0u};
+  for ( auto n = 0u; n < num_nodes && ntk.is_constant( static_cast<typename Ntk::node>( n ) ); ++n )
+  {
+    index[n] = next++;
+    expanded[n] = true;
+  }
+  for ( auto const& pi : storage.inputs )
+  {
+    index[pi] = next++;
+    expanded[pi] = true;
+  }
+  const auto num_fixed = next;
+
+  /* depth-first post-order from the outputs, without recursion */
+  std::vector<uint32_t> stack;
+  for ( auto const& po : storage.outputs )
+  {
+    if ( index[po.index] != unvisited )
+    {
+      continue;
+    }
+    stack.push_back( static_cast<uint32_t>( po.index ) );
+    while ( !stack.empty() )
+    {
+      const auto n = stack.back();
+      if ( index[n] != unvisited )
+      {
+        stack.pop_back();
+      }
+      else if ( expanded[n] )
+      {
+        index[n] = next++;
+        stack.pop_back();
+      }
+      else
+      {
+        expanded[n] = true;
+        auto const& children = nodes[n].children;
+        for ( auto it = children.rbegin(); it != children.rend(); ++it )
+        {
+          if ( !expanded[it->index] )
+          {
+            stack.push_back( static_cast<uint32_t>( it->index ) );
+          }
+        }
+      }
+    }
+  }
+  std::vector<uint32_t>().swap( stack );
+  const auto num_live = next;
+
+  /* renumber fanins, outputs, and inputs */
+  for ( auto n = 0u; n < num_nodes; ++n )
+  {
+    if ( index[n] < num_fixed || index[n] == unvisited )
+    {
+      continue;
+    }
+
+    auto& children = nodes[n].children;
+    if constexpr ( Ntk::max_fanin_size <= 3 )
+    {
+      const auto descending = children[0].index > children[1].index;
+      for ( auto& c : children )
+      {
+        c.index = index[c.index];
+      }
+      std::stable_sort( children.begin(), children.end(), [&]( auto const& a, auto const& b ) {
+        return descending ? a.index > b.index : a.index < b.index;
+      } );
+    }
+    else
+    {
+      for ( auto& c : children )
+      {
+        c.index = index[c.index];
+      }
+    }
+  }
+  for ( auto& po : storage.outputs )
+  {
+    po.index = index[po.index];
+  }
+  for ( auto& pi : storage.inputs )
+  {
+    pi = index[pi];
+  }
+
+  /* move nodes to their new positions, removed nodes to the end */
+  for ( auto n = 0u; n < num_nodes; ++n )
+  {
+    if ( index[n] == unvisited )
+    {
+      index[n] = next++;
+    }
+  }
+  for ( auto n = 0u; n < num_nodes; ++n )
+  {
+    while ( index[n] != n )
+    {
+      const auto m = index[n];
+      std::swap( nodes[n], nodes[m] );
+      std::swap( index[n], index[m] );
+    }
+  }
+  nodes.resize( num_live );
+
+  /* recount fanouts and rebuild the structural hash table */
+  for ( auto& node : nodes )
+  {
+    node.data[0].h1 = 0u;
+  }
+  for ( auto n = num_fixed; n < num_live; ++n )
+  {
+    for ( auto const& c : nodes[n].children )
+    {
+      nodes[c.index].data[0].h1++;
+    }
+  }
+  for ( auto const& po : storage.outputs )
+  {
+    nodes[po.index].data[0].h1++;
+  }
+
+  if ( !storage.hash.empty() )
+  {
+    storage.hash.clear();
+    storage.hash.reserve( num_live - num_fixed );
+    for ( auto n = num_fixed; n < num_live; ++n )
+    {
+      storage.hash.emplace( nodes[n], n );
+    }
+  }
+}
+
+} // namespace cirkit
@@ -0,0 +1,530 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sat_solver.hpp"
+#include "write_aiger.hpp"
+
+namespace cirkit
+{
+
+struct equivalence_checking_params
+{
+  /* number of random simulation patterns, rounded up to a multiple of 64 */
+  uint32_t num_patterns{1024u};
+
+  /* seed for random simulation patterns */
+  uint64_t seed{0xcafeaffe};
+
+  /* conflict limit for SAT calls on internal nodes (0 for no limit) */
+  uint64_t conflict_limit{1000u};
+
+  /* conflict limit for SAT calls on outputs (0 for no limit) */
+  uint64_t output_conflict_limit{100000u};
+};
+
+struct equivalence_checking_stats
+{
+  /* nodes that are not shared by both networks */
+  uint32_t num_nodes{0u};
+  uint32_t num_merges{0u};
+  uint32_t num_sat_calls{0u};
+  uint32_t num_counterexamples{0u};
+  uint32_t num_undecided{0u};
+};
+
+struct equivalence_checking_result
+{
+  bool equivalent{false};
+
+  /* true, if no counterexample was found, but some output could not be
+     proved within the output conflict limit (equivalent is false) */
+  bool undecided{false};
+
+  /* input assignment and the first output on which the networks differ,
+     or the first undecided output */
+  std::vector<bool> counterexample;
+  uint32_t output{0u};
+};
+
+namespace detail
+{
+
+/* SAT sweeping on an AIG in AIGER literals
+ *
+ * All nodes are simulated with random patterns and the nodes in the fanin
+ * cones of the outputs to compare are processed in topological order.
+ * Nodes in the cones of both networks serve as candidates only.  A node of
+ * one network whose simulation signature, up to complementation, matches an
+ * earlier candidate is checked for equivalence with incremental SAT, unless
+ * it is structurally equal to a candidate after replacing its fanins by their
+ * representatives.  Proved equivalent nodes are replaced
+ * by their representative in the fanin cones loaded into the solver later,
+ * and counterexamples are added as simulation patterns to refine the
+ * candidate classes.
+ */
+class sat_sweeper
+{
+public:
+  sat_sweeper( detail::aiger_builder const& aig, uint32_t num_inputs, equivalence_checking_params const& ps, equivalence_checking_stats& st )
+      : _ands( aig.ands() ),
+        _num_inputs( num_inputs ),
+        _num_vars( aig.max_var() + 1u ),
+        _ps( ps ),
+        _st( st ),
+        _repr( _num_vars ),
+        _sat_vars( _num_vars, unloaded )
+  {
+    for ( auto v = 0u; v < _num_vars; ++v )
+    {
+      _repr[v] = 2u * v;
+    }
+
+    _sims.resize( _num_vars );
+    std::mt19937_64 gen( _ps.seed );
+    const auto num_words = std::max( ( _ps.num_patterns + 63u ) / 64u, 1u );
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      _sims[0].push_back( 0u );
+      for ( auto i = 1u; i <= _num_inputs; ++i )
+      {
+        _sims[i].push_back( gen() );
+      }
+      simulate_word( w );
+    }
+  }
+
+  /* sweeps the nodes that are needed to compare the output literals */
+  void run( std::vector<uint32_t> const& outputs1, std::vector<uint32_t> const& outputs2 )
+  {
+    /* bit i of mark is set, if a node is in the fanin cone of network i + 1,
+       restricted to outputs that are not already structurally equal */
+    std::vector<uint8_t> mark( _num_vars, 0u );
+    for ( auto i = 0u; i < outputs1.size(); ++i )
+    {
+      if ( outputs1[i] != outputs2[i] )
+      {
+        mark[outputs1[i] >> 1u] |= 1u;
+        mark[outputs2[i] >> 1u] |= 2u;
+      }
+    }
+    for ( auto v = _num_vars - 1u; v > _num_inputs; --v )
+    {
+      mark[_ands[v - _num_inputs - 1u].first >> 1u] |= mark[v];
+      mark[_ands[v - _num_inputs - 1u].second >> 1u] |= mark[v];
+    }
+
+    _candidate.resize( _num_vars, false );
+    for ( auto v = 0u; v <= _num_inputs; ++v )
+    {
+      add_candidate( v );
+    }
+    _processed = _num_inputs;
+
+    /* nodes in both cones are only used as candidates */
+    for ( auto v = _num_inputs + 1u; v < _num_vars; ++v )
+    {
+      if ( mark[v] == 3u )
+      {
+        add_candidate( v );
+      }
+      else if ( mark[v] != 0u )
+      {
+        ++_st.num_nodes;
+        sweep( v );
+      }
+      _processed = v;
+    }
+  }
+
+  /* proves two literals equivalent (unsat), sets counterexample if they differ (sat) */
+  sat_result prove_outputs( uint32_t a, uint32_t b, std::vector<bool>& counterexample )
+  {
+    a = repr_literal( a );
+    b = repr_literal( b );
+    if ( a == b )
+    {
+      return sat_result::unsat;
+    }
+
+    /* counterexample from simulation */
+    for ( auto w = 0u; w < _sims[0].size(); ++w )
+    {
+      if ( const auto diff = sim_word( a, w ) ^ sim_word( b, w ); diff != 0u )
+      {
+        auto bit = 0u;
+        while ( ( ( diff >> bit ) & 1u ) == 0u )
+        {
+          ++bit;
+        }
+        counterexample.resize( _num_inputs );
+        for ( auto i = 0u; i < _num_inputs; ++i )
+        {
+          counterexample[i] = ( _sims[i + 1u][w] >> bit ) & 1u;
+        }
+        return sat_result::sat;
+      }
+    }
+
+    return check( a, b, _ps.output_conflict_limit, counterexample );
+  }
+
+private:
+  static constexpr uint32_t unloaded = UINT32_MAX;
+  static constexpr uint32_t max_solver_vars = 5000u;
+
+  /* literal of the representative of a literal */
+  uint32_t repr_literal( uint32_t lit ) const
+  {
+    return _repr[lit >> 1u] ^ ( lit & 1u );
+  }
+
+  /* adds the clauses of the transitive fanin cone of a variable to the solver,
+     in which fanins are replaced by their representatives */
+  void load_cone( uint32_t v )
+  {
+    std::vector<uint32_t> stack{v};
+    while ( !stack.empty() )
+    {
+      const auto u = stack.back();
+      if ( _sat_vars[u] != unloaded )
+      {
+        stack.pop_back();
+        continue;
+      }
+      if ( u > _num_inputs )
+      {
+        const auto a = repr_literal( _ands[u - _num_inputs - 1u].first );
+        const auto b = repr_literal( _ands[u - _num_inputs - 1u].second );
+        if ( _sat_vars[a >> 1u] == unloaded || _sat_vars[b >> 1u] == unloaded )
+        {
+          stack.push_back( a >> 1u );
+          stack.push_back( b >> 1u );
+          continue;
+        }
+      }
+      stack.pop_back();
+
+      _sat_vars[u] = _solver.add_var();
+      _loaded.push_back( u );
+      if ( u == 0u )
+      {
+        _solver.add_clause( {sat_literal( 1u )} );
+      }
+      else if ( u > _num_inputs )
+      {
+        const auto lit = sat_literal( 2u * u );
+        const auto a = repr_literal( _ands[u - _num_inputs - 1u].first );
+        const auto b = repr_literal( _ands[u - _num_inputs - 1u].second );
+        _solver.add_clause( {lit ^ 1u, sat_literal( a )} );
+        _solver.add_clause( {lit ^ 1u, sat_literal( b )} );
+        _solver.add_clause( {lit, sat_literal( a ) ^ 1u, sat_literal( b ) ^ 1u} );
+      }
+    }
+  }
+
+  uint32_t sat_literal( uint32_t lit ) const
+  {
+    return 2u * _sat_vars[lit >> 1u] + ( lit & 1u );
+  }
+
+  uint64_t sim_word( uint32_t lit, uint32_t w ) const
+  {
+    return _sims[lit >> 1u][w] ^ ( ( lit & 1u ) ? ~uint64_t( 0u ) : uint64_t( 0u ) );
+  }
+
+  void simulate_word( uint32_t w )
+  {
+    for ( auto k = 0u; k < _ands.size(); ++k )
+    {
+      auto& sim = _sims[_num_inputs + 1u + k];
+      sim.resize( w + 1u );
+      sim[w] = sim_word( _ands[k].first, w ) & sim_word( _ands[k].second, w );
+    }
+  }
+
+  /* signatures are normalized such that the first bit is 0 */
+  bool phase( uint32_t v ) const
+  {
+    return _sims[v][0] & 1u;
+  }
+
+  uint64_t signature_hash( uint32_t v ) const
+  {
+    const auto flip = phase( v ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+    uint64_t hash{0u};
+    for ( auto word : _sims[v] )
+    {
+      hash ^= ( word ^ flip ) + 0x9e3779b97f4a7c15 + ( hash << 6u ) + ( hash >> 2u );
+    }
+    return hash;
+  }
+
+  bool equal_signatures( uint32_t u, uint32_t v ) const
+  {
+    const auto flip = phase( u ) != phase( v ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+    for ( auto w = 0u; w < _sims[u].size(); ++w )
+    {
+      if ( _sims[u][w] != ( _sims[v][w] ^ flip ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* fanins of an AND node in terms of representatives, with the smaller literal first */
+  uint64_t structural_key( uint32_t v ) const
+  {
+    auto a = repr_literal( _ands[v - _num_inputs - 1u].first );
+    auto b = repr_literal( _ands[v - _num_inputs - 1u].second );
+    if ( a > b )
+    {
+      std::swap( a, b );
+    }
+    return ( static_cast<uint64_t>( a ) << 32u ) | b;
+  }
+
+  void add_candidate( uint32_t v )
+  {
+    _candidate[v] = true;
+    _classes[signature_hash( v )].push_back( v );
+    if ( v > _num_inputs )
+    {
+      _structural.emplace( structural_key( v ), v );
+    }
+  }
+
+  /* merges v without SAT, if it is trivial or structurally equal to a candidate after replacing its fanins by their representatives */
+  bool merge_structurally( uint32_t v )
+  {
+    const auto key = structural_key( v );
+    const auto a = static_cast<uint32_t>( key >> 32u ), b = static_cast<uint32_t>( key );
+    if ( a == 0u || a == ( b ^ 1u ) )
+    {
+      _repr[v] = 0u;
+    }
+    else if ( a == 1u || a == b )
+    {
+      _repr[v] = a == 1u ? b : a;
+    }
+    else if ( const auto it = _structural.find( key ); it != _structural.end() )
+    {
+      _repr[v] = 2u * it->second;
+    }
+    else
+    {
+      return false;
+    }
+    ++_st.num_merges;
+    return true;
+  }
+
+  void sweep( uint32_t v )
+  {
+    if ( merge_structurally( v ) )
+    {
+      return;
+    }
+
+    while ( true )
+    {
+      auto& cls = _classes[signature_hash( v )];
+      const auto it = std::find_if( cls.begin(), cls.end(), [&]( auto u ) { return equal_signatures( u, v ); } );
+      if ( it == cls.end() )
+      {
+        add_candidate( v );
+        return;
+      }
+
+      const auto u = *it;
+      const auto lit_u = 2u * u ^ ( phase( u ) != phase( v ) ? 1u : 0u );
+      std::vector<bool> counterexample;
+      switch ( check( 2u * v, lit_u, _ps.conflict_limit, counterexample ) )
+      {
+      case sat_result::unsat:
+        ++_st.num_merges;
+        _repr[v] = lit_u;
+        return;
+      case sat_result::undef:
+        ++_st.num_undecided;
+        add_candidate( v );
+        return;
+      case sat_result::sat:
+        ++_st.num_counterexamples;
+        add_pattern( counterexample );
+        break;
+      }
+    }
+  }
+
+  /* checks a == b with two SAT calls and adds the equivalence on success */
+  sat_result check( uint32_t a, uint32_t b, uint64_t conflict_limit, std::vector<bool>& counterexample )
+  {
+    /* restart with an empty solver once it has grown well past its size after the last restart,
+       such that the cost of reloading cones is amortized over the variables loaded in between */
+    const auto restarted = _solver.num_vars() > _restart_limit;
+    if ( restarted )
+    {
+      _solver.restart();
+      for ( auto u : _loaded )
+      {
+        _sat_vars[u] = unloaded;
+      }
+      _loaded.clear();
+    }
+
+    load_cone( a >> 1u );
+    load_cone( b >> 1u );
+    if ( restarted )
+    {
+      _restart_limit = std::max( max_solver_vars, 2u * _solver.num_vars() );
+    }
+    a = sat_literal( a );
+    b = sat_literal( b );
+
+    for ( auto const& assumptions : {std::vector<uint32_t>{a, b ^ 1u}, std::vector<uint32_t>{a ^ 1u, b}} )
+    {
+      ++_st.num_sat_calls;
+      const auto result = _solver.solve( assumptions, conflict_limit );
+      if ( result == sat_result::sat )
+      {
+        counterexample.resize( _num_inputs );
+        for ( auto i = 0u; i < _num_inputs; ++i )
+        {
+          /* inputs outside the cones are not constrained */
+          counterexample[i] = _sat_vars[i + 1u] != unloaded && _solver.model_value( _sat_vars[i + 1u] );
+        }
+      }
+      if ( result != sat_result::unsat )
+      {
+        return result;
+      }
+    }
+
+    _solver.add_clause( {a ^ 1u, b} );
+    _solver.add_clause( {a, b ^ 1u} );
+    return sat_result::unsat;
+  }
+
+  /* adds a pattern to the last simulation word, or to a new word filled with copies of it */
+  void add_pattern( std::vector<bool> const& pattern )
+  {
+    const auto bit = _num_patterns_added++ % 64u;
+    const auto w = static_cast<uint32_t>( bit == 0u ? _sims[0].size() : _sims[0].size() - 1u );
+    if ( bit == 0u )
+    {
+      _sims[0].push_back( 0u );
+      for ( auto i = 0u; i < _num_inputs; ++i )
+      {
+        _sims[i + 1u].push_back( pattern[i] ? ~uint64_t( 0u ) : uint64_t( 0u ) );
+      }
+    }
+    else
+    {
+      for ( auto i = 0u; i < _num_inputs; ++i )
+      {
+        auto& word = _sims[i + 1u][w];
+        word = pattern[i] ? ( word | ( uint64_t( 1u ) << bit ) ) : ( word & ~( uint64_t( 1u ) << bit ) );
+      }
+    }
+    simulate_word( w );
+
+    /* refine classes of processed representatives */
+    _classes.clear();
+    for ( auto u = 0u; u <= _processed; ++u )
+    {
+      if ( _candidate[u] )
+      {
+        _classes[signature_hash( u )].push_back( u );
+      }
+    }
+  }
+
+private:
+  std::vector<std::pair<uint32_t, uint32_t>> const& _ands;
+  uint32_t _num_inputs;
+  uint32_t _num_vars;
+  equivalence_checking_params const& _ps;
+  equivalence_checking_stats& _st;
+
+  sat_solver _solver;
+  std::vector<uint32_t> _repr;
+  std::vector<uint32_t> _sat_vars;
+  std::vector<uint32_t> _loaded;
+  uint32_t _restart_limit{max_solver_vars};
+  std::vector<std::vector<uint64_t>> _sims;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> _classes;
+  std::vector<bool> _candidate;
+  std::unordered_map<uint64_t, uint32_t> _structural;
+  uint32_t _processed{0u};
+  uint32_t _num_patterns_added{0u};
+};
+
+} // namespace detail
+
+/* Combinational equivalence checking with SAT sweeping
+ *
+ * Both networks are decomposed into a structurally hashed AIG over common
+ * inputs, such that logic they have in common is shared and only the
+ * remaining nodes are swept for internal equivalences before the outputs
+ * are compared pairwise.  The networks must have the same number of inputs
+ * and outputs.  Outputs that cannot be proved within the output conflict
+ * limit make the result undecided, unless another output has a
+ * counterexample.
+ */
+template<class Ntk1, class Ntk2>
+equivalence_checking_result equivalence_checking( Ntk1 const& ntk1, Ntk2 const& ntk2, equivalence_checking_params const& ps = {}, equivalence_checking_stats* pst = nullptr )
+{
+  detail::aiger_builder builder( ntk1.num_pis(), true );
+  std::vector<uint32_t> pis( ntk1.num_pis() );
+  for ( auto i = 0u; i < pis.size(); ++i )
+  {
+    pis[i] = 2u * ( i + 1u );
+  }
+  const auto outputs1 = add_to_aiger_builder( ntk1, builder, pis );
+  const auto outputs2 = add_to_aiger_builder( ntk2, builder, pis );
+
+  equivalence_checking_stats st;
+  detail::sat_sweeper sweeper( builder, ntk1.num_pis(), ps, st );
+  sweeper.run( outputs1, outputs2 );
+
+  equivalence_checking_result result;
+  auto differs = false;
+  for ( auto i = 0u; i < outputs1.size() && !differs; ++i )
+  {
+    std::vector<bool> counterexample;
+    switch ( sweeper.prove_outputs( outputs1[i], outputs2[i], counterexample ) )
+    {
+    case sat_result::sat:
+      differs = true;
+      result.undecided = false;
+      result.counterexample = counterexample;
+      result.output = i;
+      break;
+    case sat_result::undef:
+      if ( !result.undecided )
+      {
+        result.undecided = true;
+        result.output = i;
+      }
+      break;
+    case sat_result::unsat:
+      break;
+    }
+  }
+  result.equivalent = !differs && !result.undecided;
+
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return result;
+}
+
+} // namespace cirkit
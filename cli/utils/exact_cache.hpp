@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <alice/detail/mmap.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/algorithms/node_resynthesis/exact.hpp>
+
+namespace cirkit
+{
+
+/* Binary file format for exact synthesis caches (native byte order)
+ *
+ *   header:  "CKEC" version:u32 kind:u32 fanin:u32 count:u64
+ *   entry:   num_vars:u32 words:u64[max(1, 2^num_vars / 64)]
+ *            num_inputs:u32 num_steps:u32 num_outputs:u32
+ *            per step: fanin:i32[fanin] operator:u64[max(1, 2^fanin / 64)]
+ *            outputs:i32[num_outputs]
+ *
+ * The kind and fanin identify the resynthesis engine that created the
+ * chains, since chains for different engines must not be mixed.
+ */
+
+enum class exact_cache_kind : uint32_t
+{
+  lut = 0u,
+  aig = 1u,
+  xag = 2u
+};
+
+enum class exact_cache_status
+{
+  success,
+  not_found,
+  mismatch,
+  corrupt
+};
+
+namespace detail
+{
+
+constexpr char exact_cache_magic[4] = {'C', 'K', 'E', 'C'};
+constexpr uint32_t exact_cache_version = 1u;
+
+class exact_cache_reader
+{
+public:
+  exact_cache_reader( const char* begin, const char* end ) : _pos( begin ), _end( end ) {}
+
+  template<typename T>
+  bool read( T& value )
+  {
+    if ( static_cast<std::size_t>( _end - _pos ) < sizeof( T ) )
+    {
+      return false;
+    }
+    std::memcpy( &value, _pos, sizeof( T ) );
+    _pos += sizeof( T );
+    return true;
+  }
+
+  bool read_words( kitty::dynamic_truth_table& tt )
+  {
+    for ( auto& word : tt )
+    {
+      if ( !read( word ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint64_t remaining() const
+  {
+    return static_cast<uint64_t>( _end - _pos );
+  }
+
+private:
+  const char* _pos;
+  const char* _end;
+};
+
+template<typename T>
+inline void exact_cache_write( std::vector<char>& buffer, T const& value )
+{
+  const auto* p = reinterpret_cast<const char*>( &value );
+  buffer.insert( buffer.end(), p, p + sizeof( T ) );
+}
+
+inline void exact_cache_write_words( std::vector<char>& buffer, kitty::dynamic_truth_table const& tt )
+{
+  for ( auto word : tt )
+  {
+    exact_cache_write<uint64_t>( buffer, word );
+  }
+}
+
+} // namespace detail
+
+/* Loads the entries of a cache file into cache; existing entries are kept.
+ *
+ * Counts are bounded by the bytes left in the file and all fanins and
+ * output literals are checked, so that a corrupt file cannot allocate
+ * arbitrary memory or produce invalid chains.  Entries are only added
+ * if the whole file is valid.
+ */
+inline exact_cache_status load_exact_cache( const std::string& filename, exact_cache_kind kind, uint32_t fanin, mockturtle::exact_resynthesis_params::cache_map_t& cache )
+{
+  alice::detail::mapped_file file( filename );
+  if ( !file.is_open() )
+  {
+    return exact_cache_status::not_found;
+  }
+
+  detail::exact_cache_reader reader( file.begin(), file.end() );
+
+  char magic[4];
+  uint32_t version, file_kind, file_fanin;
+  uint64_t count;
+  if ( !reader.read( magic ) || std::memcmp( magic, detail::exact_cache_magic, 4u ) != 0 ||
+       !reader.read( version ) || version != detail::exact_cache_version ||
+       !reader.read( file_kind ) || !reader.read( file_fanin ) || !reader.read( count ) )
+  {
+    return exact_cache_status::corrupt;
+  }
+
+  if ( file_kind != static_cast<uint32_t>( kind ) || file_fanin != fanin )
+  {
+    return exact_cache_status::mismatch;
+  }
+
+  /* smallest entry: num_vars, one word, num_inputs, num_steps, num_outputs */
+  constexpr uint64_t min_entry_bytes = 4u + 8u + 3u * 4u;
+  if ( count > reader.remaining() / min_entry_bytes )
+  {
+    return exact_cache_status::corrupt;
+  }
+
+  mockturtle::exact_resynthesis_params::cache_map_t entries;
+  entries.reserve( count );
+
+  std::vector<int> fanins( fanin );
+  kitty::dynamic_truth_table op( fanin );
+  const uint64_t step_bytes = 4u * static_cast<uint64_t>( fanin ) + 8u * op.num_blocks();
+
+  for ( auto i = 0u; i < count; ++i )
+  {
+    uint32_t num_vars, num_inputs, num_steps, num_outputs;
+    if ( !reader.read( num_vars ) || num_vars > 16u )
+    {
+      return exact_cache_status::corrupt;
+    }
+    kitty::dynamic_truth_table function( num_vars );
+    if ( !reader.read_words( function ) ||
+         !reader.read( num_inputs ) || !reader.read( num_steps ) || !reader.read( num_outputs ) ||
+         num_inputs > num_vars ||
+         static_cast<uint64_t>( num_steps ) * step_bytes + 4u * static_cast<uint64_t>( num_outputs ) > reader.remaining() )
+    {
+      return exact_cache_status::corrupt;
+    }
+
+    percy::chain chain;
+    chain.reset( num_inputs, num_outputs, num_steps, fanin );
+
+    for ( auto s = 0u; s < num_steps; ++s )
+    {
+      for ( auto& f : fanins )
+      {
+        int32_t value;
+        /* fanins refer to inputs and previous steps */
+        if ( !reader.read( value ) || value < 0 || static_cast<uint32_t>( value ) >= num_inputs + s )
+        {
+          return exact_cache_status::corrupt;
+        }
+        f = value;
+      }
+      if ( !reader.read_words( op ) )
+      {
+        return exact_cache_status::corrupt;
+      }
+      chain.set_step( s, fanins, op );
+    }
+
+    for ( auto o = 0u; o < num_outputs; ++o )
+    {
+      int32_t lit;
+      /* variable 0 is the constant, followed by inputs and steps */
+      if ( !reader.read( lit ) || lit < 0 || ( static_cast<uint32_t>( lit ) >> 1u ) > num_inputs + num_steps )
+      {
+        return exact_cache_status::corrupt;
+      }
+      chain.set_output( o, lit );
+    }
+
+    entries.emplace( std::move( function ), std::move( chain ) );
+  }
+
+  cache.merge( entries );
+  return exact_cache_status::success;
+}
+
+/* Writes all entries of cache whose chains have the given fanin; the file is replaced only after it has been written completely.
+ *
+ * Commands share one in-memory cache for all LUT sizes, so the cache may
+ * contain chains of other fanins, which cannot be stored under the header.
+ */
+inline bool save_exact_cache( const std::string& filename, exact_cache_kind kind, uint32_t fanin, mockturtle::exact_resynthesis_params::cache_map_t const& cache )
+{
+  std::vector<char> buffer;
+  buffer.insert( buffer.end(), detail::exact_cache_magic, detail::exact_cache_magic + 4 );
+  detail::exact_cache_write<uint32_t>( buffer, detail::exact_cache_version );
+  detail::exact_cache_write<uint32_t>( buffer, static_cast<uint32_t>( kind ) );
+  detail::exact_cache_write<uint32_t>( buffer, fanin );
+  const auto matches = [&]( percy::chain const& chain ) {
+    return chain.get_fanin() == static_cast<int>( fanin );
+  };
+  detail::exact_cache_write<uint64_t>( buffer, std::count_if( cache.begin(), cache.end(), [&]( auto const& entry ) { return matches( entry.second ); } ) );
+
+  for ( auto const& [function, chain] : cache )
+  {
+    if ( !matches( chain ) )
+    {
+      continue;
+    }
+
+    detail::exact_cache_write<uint32_t>( buffer, function.num_vars() );
+    detail::exact_cache_write_words( buffer, function );
+
+    detail::exact_cache_write<uint32_t>( buffer, chain.get_nr_inputs() );
+    detail::exact_cache_write<uint32_t>( buffer, chain.get_nr_steps() );
+    detail::exact_cache_write<uint32_t>( buffer, static_cast<uint32_t>( chain.get_outputs().size() ) );
+
+    for ( auto s = 0; s < chain.get_nr_steps(); ++s )
+    {
+      for ( auto f : chain.get_step( s ) )
+      {
+        detail::exact_cache_write<int32_t>( buffer, f );
+      }
+      detail::exact_cache_write_words( buffer, chain.get_operator( s ) );
+    }
+
+    for ( auto lit : chain.get_outputs() )
+    {
+      detail::exact_cache_write<int32_t>( buffer, lit );
+    }
+  }
+
+  const auto tmp_filename = filename + ".tmp";
+  {
+    std::ofstream out( tmp_filename, std::ios::binary | std::ios::trunc );
+    if ( !out.good() )
+    {
+      return false;
+    }
+    out.write( buffer.data(), buffer.size() );
+    if ( !out.good() )
+    {
+      return false;
+    }
+  }
+
+#ifdef _WIN32
+  std::remove( filename.c_str() );
+#endif
+  return std::rename( tmp_filename.c_str(), filename.c_str() ) == 0;
+}
+
+/* Loads a cache file for a command and reports problems to err; returns false if the file must not be overwritten. */
+inline bool read_exact_cache_file( const std::string& filename, exact_cache_kind kind, uint32_t fanin, mockturtle::exact_resynthesis_params::cache_map_t& cache, std::ostream& err )
+{
+  switch ( load_exact_cache( filename, kind, fanin, cache ) )
+  {
+  case exact_cache_status::success:
+  case exact_cache_status::not_found:
+    return true;
+  case exact_cache_status::mismatch:
+    err << "[w] cache file " << filename << " was created with different synthesis parameters and is not used\n";
+    return false;
+  case exact_cache_status::corrupt:
+    err << "[w] cache file " << filename << " is corrupt and will be rewritten\n";
+    return true;
+  }
+  return true;
+}
+
+inline void write_exact_cache_file( const std::string& filename, exact_cache_kind kind, uint32_t fanin, mockturtle::exact_resynthesis_params::cache_map_t const& cache, std::ostream& err )
+{
+  if ( !save_exact_cache( filename, kind, fanin, cache ) )
+  {
+    err << "[e] could not write cache file " << filename << "\n";
+  }
+}
+
+} // namespace cirkit
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <alice/flat_network.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+#include "serialize_network.hpp"
+#include "statistics_view.hpp"
+
+namespace cirkit
+{
+
+/* Exchange of networks with C callers as flat arrays
+ *
+ * Uses the same numbering and gate types (serialized_gate) as session
+ * snapshots.  Functions are only present for LUT gates, in which they are
+ * the words of the truth table.  The mapping is not exchanged.
+ */
+template<class Ntk>
+void to_flat_network( statistics_view<Ntk> const& ntk, alice::flat_network& flat )
+{
+  std::vector<uint32_t> ids( ntk.size(), 0u );
+  const auto c1 = ntk.get_node( ntk.get_constant( true ) );
+  if ( c1 != ntk.get_node( ntk.get_constant( false ) ) )
+  {
+    ids[ntk.node_to_index( c1 )] = 1u;
+  }
+  uint32_t next_id{2u};
+
+  const auto literal = [&]( auto const& f ) {
+    return 2u * ids[ntk.node_to_index( ntk.get_node( f ) )] + ( ntk.is_complemented( f ) ? 1u : 0u );
+  };
+
+  flat.num_pis = ntk.num_pis();
+  ntk.foreach_pi( [&]( auto const& n ) {
+    ids[ntk.node_to_index( n )] = next_id++;
+  } );
+
+  flat.gate_types.reserve( ntk.num_gates() );
+  flat.fanin_offsets.reserve( ntk.num_gates() + 1u );
+  flat.function_offsets.reserve( ntk.num_gates() + 1u );
+
+  std::vector<uint32_t> fanins;
+  mockturtle::topo_view<Ntk> topo{ntk};
+  topo.foreach_gate( [&]( auto const& n ) {
+    fanins.clear();
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      fanins.push_back( literal( f ) );
+    } );
+
+    const auto kind = static_cast<uint32_t>( detail::gate_kind( ntk, n, static_cast<uint32_t>( fanins.size() ) ) );
+    if constexpr ( std::is_same_v<Ntk, mockturtle::klut_network> )
+    {
+      flat.add_gate( kind, fanins, ntk.node_function( n ) );
+    }
+    else
+    {
+      flat.add_gate( kind, fanins );
+    }
+
+    ids[ntk.node_to_index( n )] = next_id++;
+  } );
+
+  flat.outputs.reserve( ntk.num_pos() );
+  ntk.foreach_po( [&]( auto const& f ) {
+    flat.outputs.push_back( literal( f ) );
+  } );
+}
+
+template<class Ntk>
+std::shared_ptr<statistics_view<Ntk>> from_flat_network( alice_flat_network const& network )
+{
+  using signal = typename Ntk::signal;
+
+  const auto malformed = []() {
+    return std::string( "[e] malformed flat network" );
+  };
+
+  if ( network.num_gates != 0u && ( !network.gate_types || !network.fanin_offsets || !network.fanins ) )
+  {
+    throw malformed();
+  }
+  if ( network.num_pos != 0u && !network.outputs )
+  {
+    throw malformed();
+  }
+  if ( network.fanin_offsets && network.fanin_offsets[0] != 0u )
+  {
+    throw malformed();
+  }
+  if ( network.function_offsets && network.function_offsets[0] != 0u )
+  {
+    throw malformed();
+  }
+
+  Ntk ntk;
+  std::vector<signal> signals{ntk.get_constant( false ), ntk.get_constant( true )};
+  signals.reserve( 2u + network.num_pis + network.num_gates );
+
+  const auto signal_of = [&]( uint32_t lit ) {
+    if ( ( lit >> 1u ) >= signals.size() )
+    {
+      throw malformed();
+    }
+    const auto s = signals[lit >> 1u];
+    return ( lit & 1u ) ? ntk.create_not( s ) : s;
+  };
+
+  for ( auto i = 0u; i < network.num_pis; ++i )
+  {
+    signals.push_back( ntk.create_pi() );
+  }
+
+  std::vector<signal> fanins;
+  for ( auto i = 0u; i < network.num_gates; ++i )
+  {
+    const auto begin = network.fanin_offsets[i];
+    const auto end = network.fanin_offsets[i + 1u];
+    if ( end < begin || end - begin > static_cast<uint32_t>( Ntk::max_fanin_size ) )
+    {
+      throw malformed();
+    }
+
+    fanins.clear();
+    for ( auto j = begin; j < end; ++j )
+    {
+      fanins.push_back( signal_of( network.fanins[j] ) );
+    }
+
+    const auto kind = static_cast<serialized_gate>( network.gate_types[i] );
+    if constexpr ( std::is_same_v<Ntk, mockturtle::klut_network> )
+    {
+      if ( kind != serialized_gate::lut || !network.function_offsets || !network.functions )
+      {
+        throw malformed();
+      }
+
+      /* the number of words is checked before the table is allocated */
+      const auto num_vars = end - begin;
+      const auto num_blocks = num_vars <= 6u ? uint64_t( 1u ) : uint64_t( 1u ) << ( num_vars - 6u );
+      const auto words_begin = network.function_offsets[i];
+      if ( network.function_offsets[i + 1u] < words_begin || network.function_offsets[i + 1u] - words_begin != num_blocks )
+      {
+        throw malformed();
+      }
+      kitty::dynamic_truth_table function( num_vars );
+      std::copy( network.functions + words_begin, network.functions + words_begin + function.num_blocks(), function.begin() );
+      if ( num_vars < 6u )
+      {
+        /* bits beyond the function are ignored */
+        *function.begin() &= ( uint64_t( 1u ) << ( 1u << num_vars ) ) - 1u;
+      }
+      signals.push_back( ntk.create_node( fanins, function ) );
+    }
+    else
+    {
+      signals.push_back( detail::create_gate( ntk, kind, fanins, malformed ) );
+    }
+  }
+
+  for ( auto i = 0u; i < network.num_pos; ++i )
+  {
+    ntk.create_po( signal_of( network.outputs[i] ) );
+  }
+
+  return std::make_shared<statistics_view<Ntk>>( ntk );
+}
+
+} // namespace cirkit
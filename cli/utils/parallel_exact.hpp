@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+#include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/algorithms/node_resynthesis/exact.hpp>
+
+namespace cirkit
+{
+
+/* Exact synthesis results shared between threads
+ *
+ * Entries are distributed over stripes, each protected by its own mutex, such
+ * that threads working on different functions rarely contend.  An entry is
+ * queued until some thread claims it, and then solved or failed once the
+ * thread has finished.
+ */
+class striped_exact_cache
+{
+public:
+  enum class state
+  {
+    unknown,
+    queued,
+    solving,
+    solved,
+    failed
+  };
+
+  explicit striped_exact_cache( uint32_t num_stripes = 64u ) : _stripes( num_stripes )
+  {
+    for ( auto& s : _stripes )
+    {
+      s = std::make_unique<stripe>();
+    }
+  }
+
+  /* registers a function to be solved; returns false if it is already known */
+  bool enqueue( kitty::dynamic_truth_table const& function )
+  {
+    auto& s = stripe_for( function );
+    std::lock_guard<std::mutex> lock( s.mutex );
+    return s.entries.emplace( function, entry{} ).second;
+  }
+
+  /* transitions a queued function into solving; returns false if another thread was faster */
+  bool claim( kitty::dynamic_truth_table const& function )
+  {
+    auto& s = stripe_for( function );
+    std::lock_guard<std::mutex> lock( s.mutex );
+    auto it = s.entries.find( function );
+    if ( it == s.entries.end() || it->second.status != state::queued )
+    {
+      return false;
+    }
+    it->second.status = state::solving;
+    return true;
+  }
+
+  void publish( kitty::dynamic_truth_table const& function, percy::chain const* chain )
+  {
+    auto& s = stripe_for( function );
+    {
+      std::lock_guard<std::mutex> lock( s.mutex );
+      auto& e = s.entries[function];
+      if ( chain )
+      {
+        e.status = state::solved;
+        e.chain = *chain;
+      }
+      else
+      {
+        e.status = state::failed;
+      }
+    }
+    s.cv.notify_all();
+  }
+
+  /* returns the state of a function, blocks while another thread is solving it */
+  state wait( kitty::dynamic_truth_table const& function, percy::chain& chain )
+  {
+    auto& s = stripe_for( function );
+    std::unique_lock<std::mutex> lock( s.mutex );
+    auto it = s.entries.find( function );
+    if ( it == s.entries.end() )
+    {
+      return state::unknown;
+    }
+    s.cv.wait( lock, [&]() {
+      it = s.entries.find( function );
+      return it->second.status != state::solving;
+    } );
+    if ( it->second.status == state::solved )
+    {
+      chain = it->second.chain;
+    }
+    return it->second.status;
+  }
+
+  /* copies all solved entries; must only be called when no thread is working */
+  void merge_into( mockturtle::exact_resynthesis_params::cache_map_t& cache ) const
+  {
+    for ( auto const& s : _stripes )
+    {
+      for ( auto const& [function, e] : s->entries )
+      {
+        if ( e.status == state::solved )
+        {
+          cache.emplace( function, e.chain );
+        }
+      }
+    }
+  }
+
+private:
+  struct entry
+  {
+    state status{state::queued};
+    percy::chain chain;
+  };
+
+  struct stripe
+  {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::unordered_map<kitty::dynamic_truth_table, entry, kitty::hash<kitty::dynamic_truth_table>> entries;
+  };
+
+  stripe& stripe_for( kitty::dynamic_truth_table const& function )
+  {
+    return *_stripes[kitty::hash<kitty::dynamic_truth_table>()( function ) % _stripes.size()];
+  }
+
+private:
+  std::vector<std::unique_ptr<stripe>> _stripes;
+};
+
+/* Solves a single function with a fresh resynthesis engine and a private cache
+ *
+ * ResynFn creates the engine from the given parameters, ScratchNtk is the
+ * network type the engine synthesizes into.
+ */
+template<class ScratchNtk, class ResynFn>
+bool solve_exact_function( kitty::dynamic_truth_table const& function, ResynFn&& make_resyn, mockturtle::exact_resynthesis_params esps, percy::chain& chain )
+{
+  esps.cache = std::make_shared<mockturtle::exact_resynthesis_params::cache_map_t>();
+  auto resyn = make_resyn( esps );
+
+  ScratchNtk ntk;
+  std::vector<typename ScratchNtk::signal> pis( function.num_vars() );
+  std::generate( pis.begin(), pis.end(), [&]() { return ntk.create_pi(); } );
+  resyn( ntk, function, pis.begin(), pis.end(), [&]( auto const& f ) { ntk.create_po( f ); } );
+
+  const auto it = esps.cache->find( function );
+  if ( it == esps.cache->end() )
+  {
+    return false;
+  }
+  chain = it->second;
+  return true;
+}
+
+/* Collects the distinct, non-trivial cut functions of a network that are not cached yet
+ *
+ * The order follows the topological order of the cut roots, which is the
+ * order in which cut rewriting requests them.  Functions with at most fanin
+ * variables are skipped, since the engine realizes them as a single node
+ * without exact synthesis and without a cache entry.
+ */
+template<class Ntk>
+std::vector<kitty::dynamic_truth_table> uncached_cut_functions( Ntk const& ntk, mockturtle::cut_enumeration_params const& ps, uint32_t fanin, mockturtle::exact_resynthesis_params::cache_map_t const& cache )
+{
+  const auto cuts = mockturtle::cut_enumeration<Ntk, true>( ntk, ps );
+
+  std::unordered_set<kitty::dynamic_truth_table, kitty::hash<kitty::dynamic_truth_table>> seen;
+  std::vector<kitty::dynamic_truth_table> functions;
+  ntk.foreach_gate( [&]( auto const& n ) {
+    for ( auto& cut : cuts.cuts( ntk.node_to_index( n ) ) )
+    {
+      if ( cut->size() <= 1u )
+      {
+        continue;
+      }
+
+      const auto tt = cuts.truth_table( *cut );
+      if ( tt.num_vars() <= fanin || kitty::is_const0( tt ) || kitty::is_const0( ~tt ) || cache.count( tt ) || !seen.insert( tt ).second )
+      {
+        continue;
+      }
+      functions.push_back( tt );
+    }
+  } );
+
+  return functions;
+}
+
+/* Resynthesis wrapper that solves exact synthesis problems on worker threads
+ *
+ * Before rewriting, the functions to be solved are queued and picked up by
+ * the workers in order.  When the rewriting algorithm requests a function,
+ * the wrapper either takes the result of a worker, waits for a worker that
+ * is currently solving it, or solves it itself if no worker has started on
+ * it yet.  Functions without a result, e.g., because a worker hit the
+ * conflict limit, are passed to the wrapped engine as in a serial run.
+ * Results are copied into the (unsynchronized) cache of the wrapped
+ * engine on the calling thread only, such that the wrapped engine behaves
+ * exactly as in a serial run.
+ */
+template<class Ntk, class Resyn>
+class parallel_exact_resynthesis
+{
+public:
+  parallel_exact_resynthesis( Resyn& resyn, mockturtle::exact_resynthesis_params::cache_t cache, std::vector<kitty::dynamic_truth_table> functions,
+                              std::function<bool( kitty::dynamic_truth_table const&, percy::chain& )> solve, uint32_t num_threads )
+      : _resyn( resyn ),
+        _cache( cache ),
+        _functions( std::move( functions ) ),
+        _solve( solve )
+  {
+    for ( auto const& f : _functions )
+    {
+      _shared.enqueue( f );
+    }
+
+    for ( auto i = 0u; i < num_threads; ++i )
+    {
+      _workers.emplace_back( [this]() { work(); } );
+    }
+  }
+
+  ~parallel_exact_resynthesis()
+  {
+    finish();
+  }
+
+  /* stops the workers and moves all results that were found into the cache */
+  void finish()
+  {
+    _stop = true;
+    for ( auto& w : _workers )
+    {
+      w.join();
+    }
+    _workers.clear();
+    _shared.merge_into( *_cache );
+  }
+
+  template<typename LeavesIterator, typename Fn>
+  void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
+  {
+    if ( _cache->find( function ) == _cache->end() )
+    {
+      percy::chain chain;
+      switch ( _shared.claim( function ) ? striped_exact_cache::state::queued : _shared.wait( function, chain ) )
+      {
+      case striped_exact_cache::state::solved:
+        ( *_cache )[function] = chain;
+        break;
+      case striped_exact_cache::state::queued:
+      {
+        /* claimed before any worker, solve here */
+        _resyn( ntk, function, begin, end, fn );
+        const auto it = _cache->find( function );
+        _shared.publish( function, it == _cache->end() ? nullptr : &it->second );
+      }
+        return;
+      default:
+        break;
+      }
+    }
+
+    _resyn( ntk, function, begin, end, fn );
+  }
+
+  template<typename LeavesIterator, typename Fn>
+  void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, kitty::dynamic_truth_table const& dont_cares, LeavesIterator begin, LeavesIterator end, Fn&& fn )
+  {
+    _resyn( ntk, function, dont_cares, begin, end, fn );
+  }
+
+private:
+  void work()
+  {
+    percy::chain chain;
+    for ( auto i = _next++; i < _functions.size() && !_stop; i = _next++ )
+    {
+      auto const& f = _functions[i];
+      if ( !_shared.claim( f ) )
+      {
+        continue;
+      }
+      _shared.publish( f, _solve( f, chain ) ? &chain : nullptr );
+    }
+  }
+
+private:
+  Resyn& _resyn;
+  mockturtle::exact_resynthesis_params::cache_t _cache;
+  std::vector<kitty::dynamic_truth_table> _functions;
+  std::function<bool( kitty::dynamic_truth_table const&, percy::chain& )> _solve;
+
+  striped_exact_cache _shared;
+  std::atomic<std::size_t> _next{0u};
+  std::atomic<bool> _stop{false};
+  std::vector<std::thread> _workers;
+};
+
+} // namespace cirkit
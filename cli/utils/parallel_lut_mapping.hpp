@@ -0,0 +1,523 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operators.hpp>
+#include <mockturtle/algorithms/lut_mapping.hpp>
+
+namespace cirkit
+{
+
+namespace detail
+{
+
+struct priority_cut
+{
+  static constexpr uint32_t max_size = 16u;
+
+  std::array<uint32_t, max_size> leaves;
+  uint32_t size{0u};
+  uint64_t signature{0u};
+  uint32_t delay{0u};
+  float flow{0.0f};
+
+  uint32_t const* begin() const { return leaves.data(); }
+  uint32_t const* end() const { return leaves.data() + size; }
+
+  bool dominates( priority_cut const& other ) const
+  {
+    if ( size > other.size || ( signature & other.signature ) != signature )
+    {
+      return false;
+    }
+    return std::includes( other.begin(), other.end(), begin(), end() );
+  }
+
+  static priority_cut unit( uint32_t index )
+  {
+    priority_cut cut;
+    cut.leaves[0] = index;
+    cut.size = 1u;
+    cut.signature = uint64_t( 1 ) << ( index % 64u );
+    return cut;
+  }
+};
+
+/* merges two cuts, returns false if the result has more than cut_size leaves */
+inline bool merge_priority_cuts( priority_cut const& a, priority_cut const& b, uint32_t cut_size, priority_cut& result )
+{
+  if ( std::bitset<64>( a.signature | b.signature ).count() > cut_size )
+  {
+    return false;
+  }
+
+  auto i = a.begin(), j = b.begin();
+  result.size = 0u;
+  while ( i != a.end() || j != b.end() )
+  {
+    if ( result.size == cut_size )
+    {
+      return false;
+    }
+
+    if ( j == b.end() || ( i != a.end() && *i < *j ) )
+    {
+      result.leaves[result.size++] = *i++;
+    }
+    else if ( i == a.end() || *j < *i )
+    {
+      result.leaves[result.size++] = *j++;
+    }
+    else
+    {
+      result.leaves[result.size++] = *i++;
+      ++j;
+    }
+  }
+  result.signature = a.signature | b.signature;
+  return true;
+}
+
+inline void insert_irredundant( std::vector<priority_cut>& cuts, priority_cut const& cut )
+{
+  for ( auto const& other : cuts )
+  {
+    if ( other.dominates( cut ) )
+    {
+      return;
+    }
+  }
+  cuts.erase( std::remove_if( cuts.begin(), cuts.end(), [&]( auto const& other ) { return cut.dominates( other ); } ), cuts.end() );
+  cuts.push_back( cut );
+}
+
+template<class Ntk, bool StoreFunction>
+class parallel_lut_mapping_impl
+{
+public:
+  using node = typename Ntk::node;
+
+  parallel_lut_mapping_impl( Ntk& ntk, mockturtle::lut_mapping_params const& ps, uint32_t num_threads )
+      : ntk( ntk ),
+        ps( ps ),
+        num_threads( std::max( 1u, num_threads ) ),
+        cuts( ntk.size() ),
+        is_gate( ntk.size(), false ),
+        flow_refs( ntk.size() ),
+        map_refs( ntk.size(), 0u ),
+        flows( ntk.size(), 0.0f ),
+        delays( ntk.size(), 0u )
+  {
+  }
+
+  void run()
+  {
+    enumerate_cuts();
+
+    ntk.foreach_node( [&]( auto const& n ) {
+      const auto index = ntk.node_to_index( n );
+      flow_refs[index] = static_cast<float>( ntk.fanout_size( n ) );
+    } );
+
+    auto iteration = 0u;
+    for ( auto i = 0u; i < ps.rounds; ++i )
+    {
+      compute_mapping<false>( iteration++ );
+    }
+    for ( auto i = 0u; i < ps.rounds_ela; ++i )
+    {
+      compute_mapping<true>( iteration++ );
+    }
+
+    derive_mapping();
+  }
+
+private:
+  /* calls fn for each index in [0, size) using the available threads */
+  template<typename Fn>
+  void parallel_for( std::size_t size, Fn&& fn )
+  {
+    constexpr std::size_t grain = 256u;
+    const auto threads = std::min<std::size_t>( num_threads, ( size + grain - 1u ) / grain );
+    if ( threads <= 1u )
+    {
+      for ( auto i = 0u; i < size; ++i )
+      {
+        fn( i );
+      }
+      return;
+    }
+
+    std::atomic<std::size_t> next{0u};
+    const auto worker = [&]() {
+      for ( auto first = next.fetch_add( grain ); first < size; first = next.fetch_add( grain ) )
+      {
+        const auto last = std::min( first + grain, size );
+        for ( auto i = first; i < last; ++i )
+        {
+          fn( i );
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for ( auto t = 1u; t < threads; ++t )
+    {
+      workers.emplace_back( worker );
+    }
+    worker();
+    for ( auto& w : workers )
+    {
+      w.join();
+    }
+  }
+
+  /* the cut sets of a level only depend on those of lower levels, and are
+     therefore computed concurrently, level by level */
+  void enumerate_cuts()
+  {
+    std::vector<uint32_t> level( ntk.size(), 0u );
+    std::vector<std::vector<node>> gates_by_level;
+
+    ntk.foreach_node( [&]( auto const& n ) {
+      const auto index = ntk.node_to_index( n );
+      if ( ntk.is_constant( n ) )
+      {
+        cuts[index].emplace_back();
+        return;
+      }
+      if ( ntk.is_pi( n ) )
+      {
+        cuts[index].push_back( priority_cut::unit( index ) );
+        return;
+      }
+
+      is_gate[index] = true;
+      uint32_t l{0u};
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        l = std::max( l, level[ntk.node_to_index( ntk.get_node( f ) )] );
+      } );
+      level[index] = l + 1u;
+      if ( gates_by_level.size() <= l )
+      {
+        gates_by_level.resize( l + 1u );
+      }
+      gates_by_level[l].push_back( n );
+    } );
+
+    for ( auto const& gates : gates_by_level )
+    {
+      parallel_for( gates.size(), [&]( auto i ) { compute_cuts( gates[i] ); } );
+    }
+  }
+
+  void compute_cuts( node const& n )
+  {
+    const auto index = ntk.node_to_index( n );
+    const auto cut_size = std::min( ps.cut_enumeration_ps.cut_size, priority_cut::max_size );
+
+    std::vector<priority_cut> current( 1u ), next;
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      const auto& fanin_cuts = cuts[ntk.node_to_index( ntk.get_node( f ) )];
+      next.clear();
+      for ( auto const& a : current )
+      {
+        for ( auto const& b : fanin_cuts )
+        {
+          priority_cut cut;
+          if ( merge_priority_cuts( a, b, cut_size, cut ) )
+          {
+            insert_irredundant( next, cut );
+          }
+        }
+      }
+      std::swap( current, next );
+    } );
+
+    const auto fanout = std::max( 1u, static_cast<uint32_t>( ntk.fanout_size( n ) ) );
+    for ( auto& cut : current )
+    {
+      uint32_t delay{0u};
+      float flow{1.0f};
+      for ( auto leaf : cut )
+      {
+        auto const& best = cuts[leaf].front();
+        delay = std::max( delay, best.delay );
+        flow += best.flow;
+      }
+      cut.delay = delay + 1u;
+      cut.flow = flow / fanout;
+    }
+
+    std::sort( current.begin(), current.end(), []( auto const& a, auto const& b ) {
+      if ( a.delay != b.delay )
+      {
+        return a.delay < b.delay;
+      }
+      if ( a.flow != b.flow )
+      {
+        return a.flow < b.flow;
+      }
+      if ( a.size != b.size )
+      {
+        return a.size < b.size;
+      }
+      return std::lexicographical_compare( a.begin(), a.end(), b.begin(), b.end() );
+    } );
+
+    if ( current.size() + 1u > ps.cut_enumeration_ps.cut_limit )
+    {
+      current.resize( std::max( 2u, ps.cut_enumeration_ps.cut_limit ) - 1u );
+    }
+
+    /* the trivial cut is always last, such that the first cut is the best one */
+    auto unit = priority_cut::unit( index );
+    if ( !current.empty() )
+    {
+      unit.delay = current.front().delay;
+      unit.flow = current.front().flow;
+    }
+    current.push_back( unit );
+
+    cuts[index] = std::move( current );
+  }
+
+  template<bool ELA>
+  void compute_mapping( uint32_t iteration )
+  {
+    ntk.foreach_gate( [&]( auto const& n ) {
+      const auto index = ntk.node_to_index( n );
+      auto& node_cuts = cuts[index];
+
+      if constexpr ( ELA )
+      {
+        if ( map_refs[index] > 0u )
+        {
+          cut_deref( node_cuts.front() );
+        }
+      }
+
+      auto best = 0u;
+      auto best_cost = std::numeric_limits<float>::max();
+      auto best_delay = std::numeric_limits<uint32_t>::max();
+      for ( auto i = 0u; i + 1u < node_cuts.size(); ++i )
+      {
+        const auto cost = ELA ? static_cast<float>( cut_area( node_cuts[i] ) ) : cut_flow( node_cuts[i] );
+        const auto delay = cut_delay( node_cuts[i] );
+        if ( cost < best_cost || ( cost == best_cost && delay < best_delay ) )
+        {
+          best = i;
+          best_cost = cost;
+          best_delay = delay;
+        }
+      }
+      std::swap( node_cuts[0], node_cuts[best] );
+
+      if constexpr ( ELA )
+      {
+        if ( map_refs[index] > 0u )
+        {
+          cut_ref( node_cuts.front() );
+        }
+      }
+
+      flows[index] = cut_flow( node_cuts.front() ) / flow_refs[index];
+      delays[index] = cut_delay( node_cuts.front() );
+    } );
+
+    set_mapping_refs<ELA>( iteration );
+  }
+
+  template<bool ELA>
+  void set_mapping_refs( uint32_t iteration )
+  {
+    if constexpr ( !ELA )
+    {
+      std::fill( map_refs.begin(), map_refs.end(), 0u );
+      ntk.foreach_po( [&]( auto const& f ) {
+        map_refs[ntk.node_to_index( ntk.get_node( f ) )]++;
+      } );
+      for ( auto i = cuts.size(); i-- > 0u; )
+      {
+        if ( is_gate[i] && map_refs[i] > 0u )
+        {
+          for ( auto leaf : cuts[i].front() )
+          {
+            map_refs[leaf]++;
+          }
+        }
+      }
+    }
+
+    const auto coef = 1.0f / ( 1.0f + ( iteration + 1 ) * ( iteration + 1 ) );
+    for ( auto i = 0u; i < flow_refs.size(); ++i )
+    {
+      flow_refs[i] = coef * flow_refs[i] + ( 1.0f - coef ) * std::max<float>( 1.0f, map_refs[i] );
+    }
+  }
+
+  float cut_flow( priority_cut const& cut ) const
+  {
+    float flow{1.0f};
+    for ( auto leaf : cut )
+    {
+      flow += flows[leaf];
+    }
+    return flow;
+  }
+
+  uint32_t cut_delay( priority_cut const& cut ) const
+  {
+    uint32_t delay{0u};
+    for ( auto leaf : cut )
+    {
+      delay = std::max( delay, delays[leaf] );
+    }
+    return delay + 1u;
+  }
+
+  uint32_t cut_ref( priority_cut const& cut )
+  {
+    uint32_t area{1u};
+    for ( auto leaf : cut )
+    {
+      if ( is_gate[leaf] && map_refs[leaf]++ == 0u )
+      {
+        area += cut_ref( cuts[leaf].front() );
+      }
+    }
+    return area;
+  }
+
+  uint32_t cut_deref( priority_cut const& cut )
+  {
+    uint32_t area{1u};
+    for ( auto leaf : cut )
+    {
+      if ( is_gate[leaf] && --map_refs[leaf] == 0u )
+      {
+        area += cut_deref( cuts[leaf].front() );
+      }
+    }
+    return area;
+  }
+
+  uint32_t cut_area( priority_cut const& cut )
+  {
+    const auto area = cut_ref( cut );
+    cut_deref( cut );
+    return area;
+  }
+
+  kitty::dynamic_truth_table cut_function( node const& root, priority_cut const& cut ) const
+  {
+    std::unordered_map<uint32_t, kitty::dynamic_truth_table> values;
+    for ( auto i = 0u; i < cut.size; ++i )
+    {
+      kitty::dynamic_truth_table tt( cut.size );
+      kitty::create_nth_var( tt, i );
+      values.emplace( cut.leaves[i], tt );
+    }
+
+    const auto compute = [&]( auto&& self, node const& n ) -> kitty::dynamic_truth_table const& {
+      const auto index = ntk.node_to_index( n );
+      if ( const auto it = values.find( index ); it != values.end() )
+      {
+        return it->second;
+      }
+
+      if ( ntk.is_constant( n ) )
+      {
+        kitty::dynamic_truth_table tt( cut.size );
+        return values.emplace( index, ntk.constant_value( n ) ? ~tt : tt ).first->second;
+      }
+
+      std::vector<kitty::dynamic_truth_table> fanin_values;
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        fanin_values.push_back( self( self, ntk.get_node( f ) ) );
+      } );
+      return values.emplace( index, ntk.compute( n, fanin_values.begin(), fanin_values.end() ) ).first->second;
+    };
+
+    return compute( compute, root );
+  }
+
+  void derive_mapping()
+  {
+    std::vector<node> mapped;
+    ntk.foreach_gate( [&]( auto const& n ) {
+      if ( map_refs[ntk.node_to_index( n )] > 0u )
+      {
+        mapped.push_back( n );
+      }
+    } );
+
+    std::vector<kitty::dynamic_truth_table> functions;
+    if constexpr ( StoreFunction )
+    {
+      functions.resize( mapped.size() );
+      parallel_for( mapped.size(), [&]( auto i ) {
+        functions[i] = cut_function( mapped[i], cuts[ntk.node_to_index( mapped[i] )].front() );
+      } );
+    }
+
+    ntk.clear_mapping();
+    std::vector<node> leaves;
+    for ( auto i = 0u; i < mapped.size(); ++i )
+    {
+      leaves.clear();
+      for ( auto leaf : cuts[ntk.node_to_index( mapped[i] )].front() )
+      {
+        leaves.push_back( ntk.index_to_node( leaf ) );
+      }
+      ntk.add_to_mapping( mapped[i], leaves.begin(), leaves.end() );
+
+      if constexpr ( StoreFunction )
+      {
+        ntk.set_cell_function( mapped[i], functions[i] );
+      }
+    }
+  }
+
+private:
+  Ntk& ntk;
+  mockturtle::lut_mapping_params const& ps;
+  uint32_t num_threads;
+
+  std::vector<std::vector<priority_cut>> cuts;
+  std::vector<bool> is_gate;
+  std::vector<float> flow_refs;
+  std::vector<uint32_t> map_refs;
+  std::vector<float> flows;
+  std::vector<uint32_t> delays;
+};
+
+} // namespace detail
+
+/* LUT mapping with level-parallel cut enumeration
+ *
+ * Nodes are grouped by their level and the priority cuts of all nodes in a
+ * level are computed concurrently.  Cut selection follows the area flow and
+ * exact area rounds of mockturtle::lut_mapping, but cuts are enumerated
+ * and ranked by this implementation, so the mapping can differ from the one
+ * of mockturtle::lut_mapping.  The result does not depend on the number of
+ * threads.
+ */
+template<class Ntk, bool StoreFunction = false>
+void parallel_lut_mapping( Ntk& ntk, mockturtle::lut_mapping_params const& ps, uint32_t num_threads )
+{
+  detail::parallel_lut_mapping_impl<Ntk, StoreFunction> impl( ntk, ps, num_threads );
+  impl.run();
+}
+
+} // namespace cirkit
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/traits.hpp>
+
+namespace cirkit
+{
+
+/* Input patterns in bit-parallel representation
+ *
+ * Pattern j assigns bit (j % 64) of word (j / 64) of words[i] to input i.
+ * Bits in the last word beyond the number of patterns are zero.
+ */
+struct pattern_set
+{
+  explicit pattern_set( uint32_t num_inputs = 0u ) : words( num_inputs ) {}
+
+  uint32_t num_words() const
+  {
+    return ( num_patterns + 63u ) / 64u;
+  }
+
+  /* appends a pattern given as string of 0 and 1, in which the first character belongs to the first input */
+  void add_pattern( std::string const& pattern )
+  {
+    if ( num_patterns % 64u == 0u )
+    {
+      for ( auto& w : words )
+      {
+        w.push_back( 0u );
+      }
+    }
+    for ( auto i = 0u; i < words.size(); ++i )
+    {
+      if ( pattern[i] == '1' )
+      {
+        words[i].back() |= uint64_t( 1u ) << ( num_patterns % 64u );
+      }
+    }
+    ++num_patterns;
+  }
+
+  /* appends random patterns until the set contains total patterns */
+  void add_random_patterns( uint32_t total, uint64_t seed )
+  {
+    if ( total <= num_patterns )
+    {
+      return;
+    }
+
+    std::mt19937_64 rng( seed );
+    const auto old_patterns = num_patterns;
+    num_patterns = total;
+    const auto mask = num_patterns % 64u == 0u ? ~uint64_t( 0u ) : ( uint64_t( 1u ) << ( num_patterns % 64u ) ) - 1u;
+
+    for ( auto& w : words )
+    {
+      /* fill up the last, partially used word */
+      if ( old_patterns % 64u != 0u )
+      {
+        w.back() |= rng() & ~( ( uint64_t( 1u ) << ( old_patterns % 64u ) ) - 1u );
+      }
+      w.resize( num_words() );
+      std::generate( w.begin() + ( old_patterns + 63u ) / 64u, w.end(), [&]() { return rng(); } );
+      w.back() &= mask;
+    }
+  }
+
+  std::vector<std::vector<uint64_t>> words;
+  uint32_t num_patterns{0u};
+};
+
+/* Reads patterns from a file with one pattern per line
+ *
+ * Empty lines and lines starting with # are ignored.  Throws a string if a
+ * pattern does not consist of exactly num_inputs characters 0 and 1.
+ */
+inline pattern_set read_patterns( std::string const& filename, uint32_t num_inputs )
+{
+  std::ifstream in( filename );
+  if ( !in.good() )
+  {
+    throw std::string( "[e] could not open " + filename );
+  }
+
+  pattern_set patterns( num_inputs );
+  std::string line;
+  auto line_number = 0u;
+  while ( std::getline( in, line ) )
+  {
+    ++line_number;
+    if ( !line.empty() && line.back() == '\r' )
+    {
+      line.pop_back();
+    }
+    if ( line.empty() || line.front() == '#' )
+    {
+      continue;
+    }
+    if ( line.size() != num_inputs || std::any_of( line.begin(), line.end(), []( auto c ) { return c != '0' && c != '1'; } ) )
+    {
+      throw std::string( "[e] invalid pattern in line " + std::to_string( line_number ) + " of " + filename );
+    }
+    patterns.add_pattern( line );
+  }
+  return patterns;
+}
+
+namespace detail
+{
+
+/* Evaluates a LUT on words by successive multiplexing over its variables */
+inline void simulate_lut_block( kitty::dynamic_truth_table const& function, std::vector<uint64_t const*> const& fanins, uint64_t* result, uint32_t block_size, std::vector<uint64_t>& scratch )
+{
+  const auto num_vars = static_cast<uint32_t>( fanins.size() );
+  const auto num_bits = uint64_t( 1u ) << num_vars;
+
+  scratch.resize( num_bits * block_size );
+  for ( auto m = 0u; m < num_bits; ++m )
+  {
+    std::fill_n( &scratch[m * block_size], block_size, kitty::get_bit( function, m ) ? ~uint64_t( 0u ) : uint64_t( 0u ) );
+  }
+
+  for ( auto v = 0u; v < num_vars; ++v )
+  {
+    const auto* x = fanins[v];
+    for ( auto m = 0u; m < ( num_bits >> ( v + 1u ) ); ++m )
+    {
+      const auto* lo = &scratch[( 2u * m ) * block_size];
+      const auto* hi = &scratch[( 2u * m + 1u ) * block_size];
+      auto* out = &scratch[m * block_size];
+      for ( auto k = 0u; k < block_size; ++k )
+      {
+        out[k] = ( x[k] & hi[k] ) | ( ~x[k] & lo[k] );
+      }
+    }
+  }
+
+  std::copy_n( scratch.begin(), block_size, result );
+}
+
+} // namespace detail
+
+/* Simulates a network on a set of patterns and returns one signature per output
+ *
+ * Simulation proceeds in blocks of words, such that the simulation values of
+ * all nodes for one block stay in cache.  The inner loops are written over
+ * plain word arrays, which the compiler vectorizes (e.g., with AVX2 when
+ * enabled).  Gates with two fanins are simulated as AND or XOR gates, gates
+ * with three fanins as majority or XOR3 gates, and LUTs using their function.
+ */
+template<class Ntk>
+std::vector<std::vector<uint64_t>> simulate_patterns( Ntk const& ntk, pattern_set const& patterns, uint32_t block_words = 64u )
+{
+  const auto num_words = patterns.num_words();
+  std::vector<std::vector<uint64_t>> signatures( ntk.num_pos(), std::vector<uint64_t>( num_words, 0u ) );
+
+  std::vector<uint64_t> values( ntk.size() * static_cast<std::size_t>( block_words ), 0u );
+  std::vector<uint64_t const*> fanins;
+  std::vector<uint8_t> complemented;
+  std::vector<uint64_t> scratch;
+  std::vector<uint64_t> complements( 3u * block_words );
+
+  const auto node_values = [&]( auto const& n ) {
+    return &values[ntk.node_to_index( n ) * static_cast<std::size_t>( block_words )];
+  };
+
+  if constexpr ( std::is_base_of_v<mockturtle::klut_network, Ntk> )
+  {
+    /* the second constant node of a k-LUT network */
+    std::fill_n( node_values( ntk.get_node( ntk.get_constant( true ) ) ), block_words, ~uint64_t( 0u ) );
+  }
+
+  for ( auto offset = 0u; offset < num_words; offset += block_words )
+  {
+    const auto size = std::min( block_words, num_words - offset );
+
+    ntk.foreach_pi( [&]( auto const& n, auto i ) {
+      std::copy_n( &patterns.words[i][offset], size, node_values( n ) );
+    } );
+
+    ntk.foreach_gate( [&]( auto const& n ) {
+      fanins.clear();
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        const auto* v = node_values( ntk.get_node( f ) );
+        if ( ntk.is_complemented( f ) )
+        {
+          auto* c = &complements[fanins.size() * block_words];
+          for ( auto k = 0u; k < size; ++k )
+          {
+            c[k] = ~v[k];
+          }
+          v = c;
+        }
+        fanins.push_back( v );
+      } );
+
+      auto* r = node_values( n );
+      if constexpr ( std::is_base_of_v<mockturtle::klut_network, Ntk> )
+      {
+        detail::simulate_lut_block( ntk.node_function( n ), fanins, r, size, scratch );
+      }
+      else if ( fanins.size() == 2u )
+      {
+        const auto *a = fanins[0], *b = fanins[1];
+        bool is_xor{false};
+        if constexpr ( mockturtle::has_is_xor_v<Ntk> )
+        {
+          is_xor = ntk.is_xor( n );
+        }
+        if ( is_xor )
+        {
+          for ( auto k = 0u; k < size; ++k )
+          {
+            r[k] = a[k] ^ b[k];
+          }
+        }
+        else
+        {
+          for ( auto k = 0u; k < size; ++k )
+          {
+            r[k] = a[k] & b[k];
+          }
+        }
+      }
+      else
+      {
+        const auto *a = fanins[0], *b = fanins[1], *c = fanins[2];
+        bool is_xor3{false};
+        if constexpr ( mockturtle::has_is_xor3_v<Ntk> )
+        {
+          is_xor3 = ntk.is_xor3( n );
+        }
+        if ( is_xor3 )
+        {
+          for ( auto k = 0u; k < size; ++k )
+          {
+            r[k] = a[k] ^ b[k] ^ c[k];
+          }
+        }
+        else
+        {
+          for ( auto k = 0u; k < size; ++k )
+          {
+            r[k] = ( a[k] & b[k] ) | ( a[k] & c[k] ) | ( b[k] & c[k] );
+          }
+        }
+      }
+    } );
+
+    ntk.foreach_po( [&]( auto const& f, auto i ) {
+      const auto* v = node_values( ntk.get_node( f ) );
+      auto* s = &signatures[i][offset];
+      const auto mask = ntk.is_complemented( f ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+      for ( auto k = 0u; k < size; ++k )
+      {
+        s[k] = v[k] ^ mask;
+      }
+    } );
+  }
+
+  /* clear the unused bits of the last word */
+  if ( patterns.num_patterns % 64u != 0u )
+  {
+    const auto mask = ( uint64_t( 1u ) << ( patterns.num_patterns % 64u ) ) - 1u;
+    for ( auto& s : signatures )
+    {
+      s.back() &= mask;
+    }
+  }
+
+  return signatures;
+}
+
+/* Returns a signature in hexadecimal, with the last pattern as most significant digit */
+inline std::string signature_to_hex( std::vector<uint64_t> const& signature, uint32_t num_patterns )
+{
+  static constexpr char digits[] = "0123456789abcdef";
+
+  std::string hex;
+  for ( auto d = ( num_patterns + 3u ) / 4u; d > 0u; --d )
+  {
+    const auto bit = 4u * ( d - 1u );
+    hex.push_back( digits[( signature[bit / 64u] >> ( bit % 64u ) ) & 0xfu] );
+  }
+  return hex;
+}
+
+} // namespace cirkit
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <alice/detail/mmap.hpp>
+#include <mockturtle/networks/aig.hpp>
+
+namespace cirkit
+{
+
+namespace detail
+{
+
+class aiger_mapped_parser
+{
+public:
+  aiger_mapped_parser( const char* begin, const char* end ) : _pos( begin ), _end( end ) {}
+
+  bool at_end() const
+  {
+    return _pos == _end;
+  }
+
+  char peek() const
+  {
+    return *_pos;
+  }
+
+  bool consume( char c )
+  {
+    if ( _pos == _end || *_pos != c )
+    {
+      return false;
+    }
+    ++_pos;
+    return true;
+  }
+
+  bool read_uint( uint32_t& value )
+  {
+    if ( _pos == _end || *_pos < '0' || *_pos > '9' )
+    {
+      return false;
+    }
+    uint64_t v{0u};
+    while ( _pos != _end && *_pos >= '0' && *_pos <= '9' )
+    {
+      v = v * 10u + static_cast<uint64_t>( *_pos++ - '0' );
+      if ( v > UINT32_MAX )
+      {
+        return false;
+      }
+    }
+    value = static_cast<uint32_t>( v );
+    return true;
+  }
+
+  bool read_delta( uint32_t& value )
+  {
+    value = 0u;
+    for ( auto shift = 0u; shift < 35u; shift += 7u )
+    {
+      if ( _pos == _end )
+      {
+        return false;
+      }
+      const auto byte = static_cast<uint8_t>( *_pos++ );
+      /* the fifth byte holds the 4 most significant bits */
+      if ( shift == 28u && ( byte & 0xf0u ) != 0u )
+      {
+        return false;
+      }
+      value |= static_cast<uint32_t>( byte & 0x7fu ) << shift;
+      if ( ( byte & 0x80u ) == 0u )
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  const char* _pos;
+  const char* _end;
+};
+
+} // namespace detail
+
+/* Reads a combinational binary AIGER file through a memory mapping
+ *
+ * The AND section is decoded directly from the mapped file into an AIG whose
+ * storage is reserved from the header counts.  Returns false without
+ * modifying the AIG if the file is not a binary AIGER file without latches
+ * (such as ASCII AIGER), such that the caller can fall back to a general
+ * reader.  Throws a string if the file cannot be opened or is malformed,
+ * which is reported by read_io with an error prefix.
+ */
+inline bool read_aiger_mapped( const std::string& filename, mockturtle::aig_network& aig )
+{
+  alice::detail::mapped_file file( filename );
+  if ( !file.is_open() )
+  {
+    throw std::string( "could not open " + filename );
+  }
+
+  detail::aiger_mapped_parser parser( file.begin(), file.end() );
+
+  /* header: aig M I L O A [B C J F] */
+  if ( !parser.consume( 'a' ) || !parser.consume( 'i' ) || !parser.consume( 'g' ) )
+  {
+    return false;
+  }
+
+  std::vector<uint32_t> header;
+  while ( parser.consume( ' ' ) )
+  {
+    uint32_t value;
+    if ( !parser.read_uint( value ) )
+    {
+      return false;
+    }
+    header.push_back( value );
+  }
+  if ( !parser.consume( '\n' ) || header.size() < 5u )
+  {
+    return false;
+  }
+  for ( auto i = 5u; i < header.size(); ++i )
+  {
+    if ( header[i] != 0u )
+    {
+      return false;
+    }
+  }
+
+  const auto num_inputs = header[1], num_latches = header[2], num_outputs = header[3], num_ands = header[4];
+  if ( num_latches != 0u || static_cast<uint64_t>( header[0] ) != static_cast<uint64_t>( num_inputs ) + num_ands )
+  {
+    return false;
+  }
+
+  const auto malformed = [&]() {
+    return std::string( "malformed AIGER file " + filename );
+  };
+
+  std::vector<uint32_t> outputs( num_outputs );
+  for ( auto& lit : outputs )
+  {
+    if ( !parser.read_uint( lit ) || !parser.consume( '\n' ) || lit / 2u > header[0] )
+    {
+      throw malformed();
+    }
+  }
+
+  aig._storage->nodes.reserve( 1u + num_inputs + num_ands );
+  aig._storage->inputs.reserve( num_inputs );
+  aig._storage->outputs.reserve( num_outputs );
+  aig._storage->hash.reserve( num_ands );
+
+  std::vector<mockturtle::aig_network::signal> signals;
+  signals.reserve( 1u + num_inputs + num_ands );
+  signals.push_back( aig.get_constant( false ) );
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    signals.push_back( aig.create_pi() );
+  }
+
+  const auto signal = [&]( uint32_t lit ) {
+    const auto s = signals[lit >> 1u];
+    return ( lit & 1u ) ? aig.create_not( s ) : s;
+  };
+
+  auto lhs = 2u * ( num_inputs + 1u );
+  for ( auto i = 0u; i < num_ands; ++i, lhs += 2u )
+  {
+    uint32_t delta0, delta1;
+    if ( !parser.read_delta( delta0 ) || !parser.read_delta( delta1 ) || delta0 == 0u || delta0 > lhs || delta1 > lhs - delta0 )
+    {
+      throw malformed();
+    }
+    const auto rhs0 = lhs - delta0;
+    const auto rhs1 = rhs0 - delta1;
+    signals.push_back( aig.create_and( signal( rhs0 ), signal( rhs1 ) ) );
+  }
+
+  for ( auto lit : outputs )
+  {
+    aig.create_po( signal( lit ) );
+  }
+
+  return true;
+}
+
+} // namespace cirkit
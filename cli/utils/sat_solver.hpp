@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <percy/percy.hpp>
+
+namespace cirkit
+{
+
+enum class sat_result
+{
+  sat,
+  unsat,
+  undef
+};
+
+/* Incremental SAT solver based on bsat2 from ABC, as shipped with percy
+ *
+ * Variables are numbered from 0 and literals follow the AIGER convention,
+ * i.e., 2v is the positive and 2v+1 the negative literal of variable v, which
+ * is also the literal encoding of ABC.  Clauses can be added between calls to
+ * solve, which accepts assumptions and an optional conflict limit (0 for no
+ * limit).
+ */
+class sat_solver
+{
+public:
+  sat_solver() : _solver( pabc::sat_solver_new() ) {}
+
+  ~sat_solver()
+  {
+    pabc::sat_solver_delete( _solver );
+  }
+
+  sat_solver( sat_solver const& ) = delete;
+  sat_solver& operator=( sat_solver const& ) = delete;
+
+  uint32_t add_var()
+  {
+    return static_cast<uint32_t>( pabc::sat_solver_addvar( _solver ) );
+  }
+
+  uint32_t num_vars() const
+  {
+    return static_cast<uint32_t>( pabc::sat_solver_nvars( _solver ) );
+  }
+
+  /* adds a clause, returns false if the clauses became unsatisfiable */
+  bool add_clause( std::vector<uint32_t> const& lits )
+  {
+    _lits.assign( lits.begin(), lits.end() );
+    return pabc::sat_solver_addclause( _solver, _lits.data(), _lits.data() + _lits.size() ) != 0;
+  }
+
+  sat_result solve( std::vector<uint32_t> const& assumptions = {}, uint64_t conflict_limit = 0u )
+  {
+    _lits.assign( assumptions.begin(), assumptions.end() );
+    /* returns 1 (l_True), -1 (l_False), or 0 (l_Undef) if the conflict limit is reached */
+    switch ( pabc::sat_solver_solve( _solver, _lits.data(), _lits.data() + _lits.size(), static_cast<int64_t>( conflict_limit ), 0, 0, 0 ) )
+    {
+    case 1:
+      return sat_result::sat;
+    case -1:
+      return sat_result::unsat;
+    default:
+      return sat_result::undef;
+    }
+  }
+
+  /* value of a variable in the model of the last satisfiable call */
+  bool model_value( uint32_t var ) const
+  {
+    return pabc::sat_solver_var_value( _solver, static_cast<int>( var ) ) != 0;
+  }
+
+  /* removes all variables and clauses */
+  void restart()
+  {
+    pabc::sat_solver_restart( _solver );
+  }
+
+private:
+  pabc::sat_solver* _solver;
+  std::vector<pabc::lit> _lits;
+};
+
+} // namespace cirkit
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <alice/serialization.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/traits.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+#include "statistics_view.hpp"
+
+namespace cirkit
+{
+
+/* Binary format of networks in session snapshots
+ *
+ *   num_pis:u32
+ *   num_gates:u32, per gate: kind:u32 num_fanins:u32 fanins:u32[num_fanins]
+ *                            (LUT gates only) function:u64[num_blocks]
+ *   num_pos:u32 outputs:u32[num_pos]
+ *   has_mapping:u32, if set: num_cells:u32, per cell: root:u32 num_leaves:u32
+ *                            leaves:u32[num_leaves] function:u64[num_blocks]
+ *
+ * Nodes are numbered by ids, in which 0 and 1 are the constants, followed by
+ * the primary inputs and the gates in topological order.  Fanins and outputs
+ * are literals 2 * id + complement.  Only gates in the transitive fanin of
+ * the outputs are stored.
+ */
+enum class serialized_gate : uint32_t
+{
+  and_ = 0u,
+  xor_ = 1u,
+  maj = 2u,
+  xor3 = 3u,
+  lut = 4u
+};
+
+namespace detail
+{
+
+inline void write_words( alice::binary_writer& out, kitty::dynamic_truth_table const& tt )
+{
+  for ( auto word : tt )
+  {
+    out.write<uint64_t>( word );
+  }
+}
+
+inline void read_words( alice::binary_reader& in, kitty::dynamic_truth_table& tt )
+{
+  for ( auto& word : tt )
+  {
+    word = in.read<uint64_t>();
+  }
+}
+
+/* kind of a gate, which is a LUT in k-LUT networks and otherwise determined by its fanin size */
+template<class Ntk>
+serialized_gate gate_kind( statistics_view<Ntk> const& ntk, typename Ntk::node const& n, uint32_t num_fanins )
+{
+  if constexpr ( std::is_same_v<Ntk, mockturtle::klut_network> )
+  {
+    (void)ntk;
+    (void)n;
+    (void)num_fanins;
+    return serialized_gate::lut;
+  }
+  else if ( num_fanins == 2u )
+  {
+    if constexpr ( mockturtle::has_is_xor_v<Ntk> )
+    {
+      if ( ntk.is_xor( n ) )
+      {
+        return serialized_gate::xor_;
+      }
+    }
+    return serialized_gate::and_;
+  }
+  else
+  {
+    if constexpr ( mockturtle::has_is_xor3_v<Ntk> )
+    {
+      if ( ntk.is_xor3( n ) )
+      {
+        return serialized_gate::xor3;
+      }
+    }
+    return serialized_gate::maj;
+  }
+}
+
+/* creates a gate other than a LUT, throws the result of malformed() if kind and fanins do not match */
+template<class Ntk, class Malformed>
+typename Ntk::signal create_gate( Ntk& ntk, serialized_gate kind, std::vector<typename Ntk::signal> const& fanins, Malformed&& malformed )
+{
+  if ( fanins.size() != ( kind == serialized_gate::and_ || kind == serialized_gate::xor_ ? 2u : 3u ) )
+  {
+    throw malformed();
+  }
+
+  switch ( kind )
+  {
+  case serialized_gate::and_:
+    return ntk.create_and( fanins[0], fanins[1] );
+  case serialized_gate::xor_:
+    return ntk.create_xor( fanins[0], fanins[1] );
+  case serialized_gate::maj:
+    return ntk.create_maj( fanins[0], fanins[1], fanins[2] );
+  case serialized_gate::xor3:
+    if constexpr ( mockturtle::has_create_xor3_v<Ntk> )
+    {
+      return ntk.create_xor3( fanins[0], fanins[1], fanins[2] );
+    }
+    else
+    {
+      return ntk.create_xor( ntk.create_xor( fanins[0], fanins[1] ), fanins[2] );
+    }
+  default:
+    throw malformed();
+  }
+}
+
+} // namespace detail
+
+template<class Ntk>
+void serialize_network( statistics_view<Ntk> const& ntk, alice::binary_writer& out )
+{
+  using node = typename Ntk::node;
+
+  std::vector<uint32_t> ids( ntk.size(), 0u );
+  const auto c1 = ntk.get_node( ntk.get_constant( true ) );
+  if ( c1 != ntk.get_node( ntk.get_constant( false ) ) )
+  {
+    ids[ntk.node_to_index( c1 )] = 1u;
+  }
+  uint32_t next_id{2u};
+
+  const auto literal = [&]( auto const& f ) {
+    return 2u * ids[ntk.node_to_index( ntk.get_node( f ) )] + ( ntk.is_complemented( f ) ? 1u : 0u );
+  };
+
+  out.write<uint32_t>( ntk.num_pis() );
+  ntk.foreach_pi( [&]( auto const& n ) {
+    ids[ntk.node_to_index( n )] = next_id++;
+  } );
+
+  std::vector<node> gates;
+  mockturtle::topo_view<Ntk> topo{ntk};
+  topo.foreach_gate( [&]( auto const& n ) {
+    gates.push_back( n );
+  } );
+
+  out.write<uint32_t>( static_cast<uint32_t>( gates.size() ) );
+  std::vector<uint32_t> fanins;
+  for ( auto const& n : gates )
+  {
+    fanins.clear();
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      fanins.push_back( literal( f ) );
+    } );
+
+    out.write<uint32_t>( static_cast<uint32_t>( detail::gate_kind( ntk, n, static_cast<uint32_t>( fanins.size() ) ) ) );
+    out.write<uint32_t>( static_cast<uint32_t>( fanins.size() ) );
+    for ( auto lit : fanins )
+    {
+      out.write<uint32_t>( lit );
+    }
+    if constexpr ( std::is_same_v<Ntk, mockturtle::klut_network> )
+    {
+      detail::write_words( out, ntk.node_function( n ) );
+    }
+
+    ids[ntk.node_to_index( n )] = next_id++;
+  }
+
+  out.write<uint32_t>( ntk.num_pos() );
+  ntk.foreach_po( [&]( auto const& f ) {
+    out.write<uint32_t>( literal( f ) );
+  } );
+
+  out.write<uint32_t>( ntk.has_mapping() ? 1u : 0u );
+  if ( ntk.has_mapping() )
+  {
+    std::vector<node> roots;
+    for ( auto const& n : gates )
+    {
+      if ( ntk.is_cell_root( n ) )
+      {
+        roots.push_back( n );
+      }
+    }
+
+    out.write<uint32_t>( static_cast<uint32_t>( roots.size() ) );
+    std::vector<uint32_t> leaves;
+    for ( auto const& n : roots )
+    {
+      leaves.clear();
+      ntk.foreach_cell_fanin( n, [&]( auto const& leaf ) {
+        leaves.push_back( ids[ntk.node_to_index( leaf )] );
+      } );
+
+      out.write<uint32_t>( ids[ntk.node_to_index( n )] );
+      out.write<uint32_t>( static_cast<uint32_t>( leaves.size() ) );
+      for ( auto id : leaves )
+      {
+        out.write<uint32_t>( id );
+      }
+      detail::write_words( out, ntk.cell_function( n ) );
+    }
+  }
+}
+
+template<class Ntk>
+std::shared_ptr<statistics_view<Ntk>> deserialize_network( alice::binary_reader& in )
+{
+  using signal = typename Ntk::signal;
+
+  const auto malformed = []() {
+    return std::string( "[e] malformed network in session file" );
+  };
+
+  Ntk ntk;
+  std::vector<signal> signals{ntk.get_constant( false ), ntk.get_constant( true )};
+
+  const auto signal_of = [&]( uint32_t lit ) {
+    if ( ( lit >> 1u ) >= signals.size() )
+    {
+      throw malformed();
+    }
+    const auto s = signals[lit >> 1u];
+    return ( lit & 1u ) ? ntk.create_not( s ) : s;
+  };
+
+  const auto num_pis = in.read<uint32_t>();
+  for ( auto i = 0u; i < num_pis; ++i )
+  {
+    signals.push_back( ntk.create_pi() );
+  }
+
+  const auto num_gates = in.read<uint32_t>();
+  std::vector<signal> fanins;
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto kind = static_cast<serialized_gate>( in.read<uint32_t>() );
+    const auto num_fanins = in.read<uint32_t>();
+    if ( num_fanins > 32u )
+    {
+      throw malformed();
+    }
+
+    fanins.clear();
+    for ( auto j = 0u; j < num_fanins; ++j )
+    {
+      fanins.push_back( signal_of( in.read<uint32_t>() ) );
+    }
+
+    if constexpr ( std::is_same_v<Ntk, mockturtle::klut_network> )
+    {
+      if ( kind != serialized_gate::lut )
+      {
+        throw malformed();
+      }
+      kitty::dynamic_truth_table function( num_fanins );
+      detail::read_words( in, function );
+      signals.push_back( ntk.create_node( fanins, function ) );
+    }
+    else
+    {
+      signals.push_back( detail::create_gate( ntk, kind, fanins, malformed ) );
+    }
+  }
+
+  const auto num_pos = in.read<uint32_t>();
+  for ( auto i = 0u; i < num_pos; ++i )
+  {
+    ntk.create_po( signal_of( in.read<uint32_t>() ) );
+  }
+
+  auto result = std::make_shared<statistics_view<Ntk>>( ntk );
+
+  if ( in.read<uint32_t>() != 0u )
+  {
+    const auto node_of = [&]( uint32_t id ) {
+      if ( id >= signals.size() )
+      {
+        throw malformed();
+      }
+      return ntk.get_node( signals[id] );
+    };
+
+    const auto num_cells = in.read<uint32_t>();
+    std::vector<typename Ntk::node> leaves;
+    for ( auto i = 0u; i < num_cells; ++i )
+    {
+      const auto root = node_of( in.read<uint32_t>() );
+      const auto num_leaves = in.read<uint32_t>();
+      if ( num_leaves > 32u )
+      {
+        throw malformed();
+      }
+
+      leaves.clear();
+      for ( auto j = 0u; j < num_leaves; ++j )
+      {
+        leaves.push_back( node_of( in.read<uint32_t>() ) );
+      }
+      kitty::dynamic_truth_table function( num_leaves );
+      detail::read_words( in, function );
+
+      /* structural hashing may have merged the root with a leaf-level node */
+      if ( ntk.is_constant( root ) || ntk.is_pi( root ) )
+      {
+        continue;
+      }
+      result->add_to_mapping( root, leaves.begin(), leaves.end() );
+      result->set_cell_function( root, function );
+    }
+  }
+
+  return result;
+}
+
+} // namespace cirkit
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <mockturtle/traits.hpp>
+#include <mockturtle/views/mapping_view.hpp>
+
+namespace cirkit
+{
+
+struct network_statistics
+{
+  uint32_t depth{0u};
+  uint32_t num_gates{0u};
+
+  /* gate type counts, only for networks with several gate types */
+  uint32_t num_and{0u};
+  uint32_t num_xor{0u};
+  uint32_t num_maj{0u};
+  uint32_t num_xor3{0u};
+};
+
+/* Mapping view that caches structural statistics
+ *
+ * Statistics are computed on first access and kept until they are
+ * invalidated.  Algorithms that modify a network through a pointer to its
+ * base type cannot invalidate them, therefore the cache additionally keeps
+ * the storage, size, and number of outputs of the network it was computed
+ * for and is recomputed whenever one of them has changed.
+ */
+template<class Ntk>
+class statistics_view : public mockturtle::mapping_view<Ntk, true>
+{
+public:
+  using mockturtle::mapping_view<Ntk, true>::mapping_view;
+
+  network_statistics const& statistics() const
+  {
+    if ( !_valid || _storage_key != this->_storage.get() || _size_key != this->size() || _pos_key != this->num_pos() )
+    {
+      compute_statistics();
+    }
+    return _statistics;
+  }
+
+  void invalidate_statistics()
+  {
+    _valid = false;
+  }
+
+private:
+  void compute_statistics() const
+  {
+    _statistics = {};
+
+    std::vector<uint32_t> levels( this->size(), 0u );
+    this->foreach_gate( [&]( auto const& n ) {
+      uint32_t level{0u};
+      this->foreach_fanin( n, [&]( auto const& f ) {
+        level = std::max( level, levels[this->node_to_index( this->get_node( f ) )] );
+      } );
+      levels[this->node_to_index( n )] = level + 1u;
+
+      ++_statistics.num_gates;
+      if constexpr ( mockturtle::has_is_xor_v<Ntk> || mockturtle::has_is_xor3_v<Ntk> )
+      {
+        count_gate_type( n );
+      }
+    } );
+
+    this->foreach_po( [&]( auto const& f ) {
+      _statistics.depth = std::max( _statistics.depth, levels[this->node_to_index( this->get_node( f ) )] );
+    } );
+
+    _storage_key = this->_storage.get();
+    _size_key = this->size();
+    _pos_key = this->num_pos();
+    _valid = true;
+  }
+
+  void count_gate_type( typename Ntk::node const& n ) const
+  {
+    if constexpr ( mockturtle::has_is_and_v<Ntk> )
+    {
+      if ( this->is_and( n ) )
+      {
+        ++_statistics.num_and;
+      }
+    }
+    if constexpr ( mockturtle::has_is_maj_v<Ntk> )
+    {
+      if ( this->is_maj( n ) )
+      {
+        ++_statistics.num_maj;
+      }
+    }
+    if constexpr ( mockturtle::has_is_xor_v<Ntk> )
+    {
+      if ( this->is_xor( n ) )
+      {
+        ++_statistics.num_xor;
+      }
+    }
+    if constexpr ( mockturtle::has_is_xor3_v<Ntk> )
+    {
+      if ( this->is_xor3( n ) )
+      {
+        ++_statistics.num_xor3;
+      }
+    }
+  }
+
+private:
+  mutable network_statistics _statistics;
+  mutable bool _valid{false};
+  mutable void const* _storage_key{nullptr};
+  mutable uint32_t _size_key{0u};
+  mutable uint32_t _pos_key{0u};
+};
+
+template<class T>
+inline void invalidate_statistics( T const& )
+{
+}
+
+template<class Ntk>
+inline void invalidate_statistics( std::shared_ptr<statistics_view<Ntk>> const& ntk )
+{
+  if ( ntk )
+  {
+    ntk->invalidate_statistics();
+  }
+}
+
+} // namespace cirkit
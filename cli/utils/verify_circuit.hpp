@@ -0,0 +1,362 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "classical_simulation.hpp"
+#include "pattern_simulation.hpp"
+
+namespace cirkit
+{
+
+/* Result of an exhaustive check of a reversible circuit
+ *
+ * If the circuit is not equivalent, counterexample is an input assignment
+ * on which it differs, where bit i is the value of input qubit i.  For
+ * checks against a logic network, output_qubits[i] is the qubit that holds
+ * output i and complemented[i] is true, if it holds the complement.
+ */
+struct circuit_verification_result
+{
+  bool equivalent{false};
+  std::optional<uint64_t> counterexample;
+  std::vector<uint32_t> output_qubits;
+  std::vector<bool> complemented;
+};
+
+namespace detail
+{
+
+/* word w of the exhaustive simulation of input i, i.e., bit b is bit i of 64w + b */
+inline uint64_t exhaustive_word( uint32_t i, uint64_t w )
+{
+  static constexpr uint64_t projections[] = {
+      0xaaaaaaaaaaaaaaaa, 0xcccccccccccccccc, 0xf0f0f0f0f0f0f0f0,
+      0xff00ff00ff00ff00, 0xffff0000ffff0000, 0xffffffff00000000};
+  return i < 6u ? projections[i] : ( ( ( w >> ( i - 6u ) ) & 1u ) ? ~uint64_t( 0u ) : uint64_t( 0u ) );
+}
+
+/* simulates a block of words of the exhaustive simulation; non-input qubits start in 0 */
+inline void simulate_exhaustive_block( std::vector<classical_gate> const& gates, uint32_t num_qubits, uint32_t num_inputs, uint64_t offset, uint32_t size, pattern_set& state )
+{
+  state.words.resize( num_qubits );
+  for ( auto q = 0u; q < num_qubits; ++q )
+  {
+    state.words[q].resize( size );
+    for ( auto k = 0u; k < size; ++k )
+    {
+      state.words[q][k] = q < num_inputs ? exhaustive_word( q, offset + k ) : 0u;
+    }
+  }
+  state.num_patterns = 64u * size;
+  simulate_classical_gates( gates, state );
+}
+
+/* runs fn( offset, size ) on blocks of words with num_threads threads until fn returns false */
+template<class Fn>
+void foreach_exhaustive_block( uint64_t num_words, uint32_t block_words, uint32_t num_threads, Fn&& fn )
+{
+  std::atomic<uint64_t> next_block{0u};
+  std::atomic<bool> stop{false};
+  const auto num_blocks = ( num_words + block_words - 1u ) / block_words;
+
+  const auto worker = [&]() {
+    while ( !stop )
+    {
+      const auto block = next_block++;
+      if ( block >= num_blocks )
+      {
+        break;
+      }
+      const auto offset = block * block_words;
+      const auto size = static_cast<uint32_t>( std::min<uint64_t>( block_words, num_words - offset ) );
+      if ( !fn( offset, size ) )
+      {
+        stop = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for ( auto i = 1u; i < std::max( num_threads, 1u ); ++i )
+  {
+    workers.emplace_back( worker );
+  }
+  worker();
+  for ( auto& w : workers )
+  {
+    w.join();
+  }
+}
+
+/* value of each qubit after the uncontrolled NOT gates that are applied to it before any other gate, as for constant qubits */
+inline std::vector<bool> prepared_values( std::vector<classical_gate> const& gates, uint32_t num_qubits )
+{
+  std::vector<bool> value( num_qubits, false ), touched( num_qubits, false );
+  for ( auto const& g : gates )
+  {
+    for ( auto q : g.controls )
+    {
+      touched[q] = true;
+    }
+    for ( auto q : g.targets )
+    {
+      if ( g.controls.empty() && !touched[q] )
+      {
+        value[q] = !value[q];
+      }
+      else
+      {
+        touched[q] = true;
+      }
+    }
+  }
+  return value;
+}
+
+/* keeps the smallest counterexample found by any thread */
+class counterexample_collector
+{
+public:
+  void add( uint64_t assignment )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( !_counterexample || assignment < *_counterexample )
+    {
+      _counterexample = assignment;
+    }
+  }
+
+  std::optional<uint64_t> get() const
+  {
+    return _counterexample;
+  }
+
+private:
+  std::mutex _mutex;
+  std::optional<uint64_t> _counterexample;
+};
+
+} // namespace detail
+
+/* Checks whether a circuit over n qubits realizes a permutation over 2^n elements
+ *
+ * The circuit is simulated on all basis states, 64 states per word and in
+ * blocks of words that are distributed over num_threads threads.
+ */
+inline circuit_verification_result verify_permutation( std::vector<classical_gate> const& gates, uint32_t num_qubits, std::vector<uint16_t> const& perm, uint32_t num_threads, uint32_t block_words = 64u )
+{
+  const auto num_states = uint64_t( 1u ) << num_qubits;
+  const auto num_words = std::max<uint64_t>( num_states / 64u, 1u );
+  detail::counterexample_collector counterexample;
+
+  detail::foreach_exhaustive_block( num_words, block_words, num_threads, [&]( uint64_t offset, uint32_t size ) {
+    pattern_set state;
+    detail::simulate_exhaustive_block( gates, num_qubits, num_qubits, offset, size, state );
+
+    for ( auto k = 0u; k < size; ++k )
+    {
+      for ( auto b = 0u; b < 64u; ++b )
+      {
+        const auto x = 64u * ( offset + k ) + b;
+        if ( x >= num_states )
+        {
+          break;
+        }
+        uint64_t y{0u};
+        for ( auto q = 0u; q < num_qubits; ++q )
+        {
+          y |= ( ( state.words[q][k] >> b ) & 1u ) << q;
+        }
+        if ( y != perm[x] )
+        {
+          counterexample.add( x );
+          return false;
+        }
+      }
+    }
+    return true;
+  } );
+
+  circuit_verification_result result;
+  result.counterexample = counterexample.get();
+  result.equivalent = !result.counterexample;
+  return result;
+}
+
+/* Checks whether a circuit computes the outputs of a logic network
+ *
+ * The first qubits of the circuit are the inputs of the network and all
+ * other qubits are initialized to 0, as in circuits created by
+ * logic_network_synthesis.  Constant qubits are prepared with NOT gates
+ * before they are used otherwise.  If output_qubits is not empty, it
+ * contains the qubit that holds each output (e.g., as recorded by
+ * logic_network_synthesis), and the qubit must hold the value of the node
+ * that drives the output.  Otherwise, the qubits are identified by matching
+ * the outputs against all qubits on all states, such that outputs driven by
+ * the same node, by an input, or by a constant can share a qubit.  The
+ * circuit is equivalent, if all input qubits are restored, the output
+ * qubits hold the outputs (possibly complemented), and all other qubits
+ * hold their initial or prepared constant value on all states.
+ */
+template<class Ntk>
+circuit_verification_result verify_logic_network( std::vector<classical_gate> const& gates, uint32_t num_qubits, Ntk const& ntk, uint32_t num_threads, std::vector<uint32_t> const& output_qubits = {}, uint32_t block_words = 64u )
+{
+  const auto num_inputs = ntk.num_pis();
+  const auto num_states = uint64_t( 1u ) << num_inputs;
+  const auto num_words = std::max<uint64_t>( num_states / 64u, 1u );
+  const auto mask = num_states < 64u ? ( uint64_t( 1u ) << num_states ) - 1u : ~uint64_t( 0u );
+
+  const auto simulate_network = [&]( uint64_t offset, uint32_t size ) {
+    pattern_set inputs( num_inputs );
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      inputs.words[i].resize( size );
+      for ( auto k = 0u; k < size; ++k )
+      {
+        inputs.words[i][k] = detail::exhaustive_word( i, offset + k ) & mask;
+      }
+    }
+    inputs.num_patterns = static_cast<uint32_t>( std::min<uint64_t>( 64u * size, num_states ) );
+    return simulate_patterns( ntk, inputs );
+  };
+
+  circuit_verification_result result;
+  if ( !output_qubits.empty() )
+  {
+    result.output_qubits = output_qubits;
+    ntk.foreach_po( [&]( auto const& f ) {
+      result.complemented.push_back( ntk.is_complemented( f ) );
+    } );
+  }
+  else
+  {
+    /* candidates[i][2q + c] is true, if qubit q (complemented if c) matches output i on all states seen so far */
+    std::vector<std::vector<bool>> candidates( ntk.num_pos(), std::vector<bool>( 2u * num_qubits, true ) );
+    std::mutex candidates_mutex;
+
+    detail::foreach_exhaustive_block( num_words, block_words, num_threads, [&]( uint64_t offset, uint32_t size ) {
+      pattern_set state;
+      detail::simulate_exhaustive_block( gates, num_qubits, num_inputs, offset, size, state );
+      const auto outputs = simulate_network( offset, size );
+
+      std::vector<std::vector<bool>> mismatches( outputs.size(), std::vector<bool>( 2u * num_qubits, false ) );
+      for ( auto i = 0u; i < outputs.size(); ++i )
+      {
+        for ( auto q = 0u; q < num_qubits; ++q )
+        {
+          for ( auto k = 0u; k < size; ++k )
+          {
+            const auto diff = ( outputs[i][k] ^ state.words[q][k] ) & mask;
+            mismatches[i][2u * q] = mismatches[i][2u * q] || diff != 0u;
+            mismatches[i][2u * q + 1u] = mismatches[i][2u * q + 1u] || diff != mask;
+          }
+        }
+      }
+
+      std::lock_guard<std::mutex> lock( candidates_mutex );
+      for ( auto i = 0u; i < outputs.size(); ++i )
+      {
+        for ( auto j = 0u; j < 2u * num_qubits; ++j )
+        {
+          candidates[i][j] = candidates[i][j] && !mismatches[i][j];
+        }
+      }
+      return true;
+    } );
+
+    /* outputs prefer a non-input qubit that holds no other output, such that copies of an output are not taken for garbage */
+    std::vector<bool> taken( num_qubits, false );
+    for ( auto const& c : candidates )
+    {
+      auto found = false;
+      for ( auto shared : {false, true} )
+      {
+        for ( auto q = shared ? 0u : num_inputs; q < num_qubits && !found; ++q )
+        {
+          for ( auto complemented : {false, true} )
+          {
+            if ( ( shared || !taken[q] ) && c[2u * q + ( complemented ? 1u : 0u )] )
+            {
+              result.output_qubits.push_back( q );
+              result.complemented.push_back( complemented );
+              taken[q] = true;
+              found = true;
+              break;
+            }
+          }
+        }
+      }
+      if ( !found )
+      {
+        return result;
+      }
+    }
+  }
+
+  /* input qubits are always checked to be restored, also if they hold an output */
+  std::vector<bool> is_output( num_qubits, false );
+  for ( auto q : result.output_qubits )
+  {
+    is_output[q] = q >= num_inputs;
+  }
+  const auto prepared = detail::prepared_values( gates, num_qubits );
+
+  detail::counterexample_collector counterexample;
+  detail::foreach_exhaustive_block( num_words, block_words, num_threads, [&]( uint64_t offset, uint32_t size ) {
+    pattern_set state;
+    detail::simulate_exhaustive_block( gates, num_qubits, num_inputs, offset, size, state );
+    const auto outputs = simulate_network( offset, size );
+
+    const auto fail = [&]( uint32_t k, uint64_t diff ) {
+      auto b = 0u;
+      while ( ( ( diff >> b ) & 1u ) == 0u )
+      {
+        ++b;
+      }
+      counterexample.add( 64u * ( offset + k ) + b );
+      return false;
+    };
+
+    for ( auto i = 0u; i < outputs.size(); ++i )
+    {
+      const auto& values = state.words[result.output_qubits[i]];
+      const auto flip = result.complemented[i] ? ~uint64_t( 0u ) : uint64_t( 0u );
+      for ( auto k = 0u; k < size; ++k )
+      {
+        if ( const auto diff = ( outputs[i][k] ^ values[k] ^ flip ) & mask; diff != 0u )
+        {
+          return fail( k, diff );
+        }
+      }
+    }
+    for ( auto q = 0u; q < num_qubits; ++q )
+    {
+      if ( is_output[q] )
+      {
+        continue;
+      }
+      for ( auto k = 0u; k < size; ++k )
+      {
+        const auto expected = q < num_inputs ? detail::exhaustive_word( q, offset + k ) : ( prepared[q] ? ~uint64_t( 0u ) : uint64_t( 0u ) );
+        if ( const auto diff = ( state.words[q][k] ^ expected ) & mask; diff != 0u )
+        {
+          return fail( k, diff );
+        }
+      }
+    }
+    return true;
+  } );
+
+  result.counterexample = counterexample.get();
+  result.equivalent = !result.counterexample;
+  return result;
+}
+
+} // namespace cirkit
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mockturtle/traits.hpp>
+
+namespace cirkit
+{
+
+namespace detail
+{
+
+/* Collects the AND gates of an AIG while decomposing other gate types
+ *
+ * Literals follow the AIGER convention, i.e., variable v has literals 2v and
+ * 2v+1, and literals 0 and 1 are the constants.  Trivial ANDs are not created,
+ * such that gates with constant or duplicate fanins are simplified.  If strash
+ * is set, structurally equal ANDs are created only once.
+ */
+class aiger_builder
+{
+public:
+  explicit aiger_builder( uint32_t num_inputs, bool strash = false ) : _next_var( num_inputs + 1u ), _strash( strash ) {}
+
+  uint32_t create_and( uint32_t a, uint32_t b )
+  {
+    if ( a < b )
+    {
+      std::swap( a, b );
+    }
+    if ( b == 0u || a == ( b ^ 1u ) )
+    {
+      return 0u;
+    }
+    if ( b == 1u || a == b )
+    {
+      return a;
+    }
+    if ( _strash )
+    {
+      const auto [it, inserted] = _hash.emplace( ( static_cast<uint64_t>( a ) << 32u ) | b, 2u * _next_var );
+      if ( !inserted )
+      {
+        return it->second;
+      }
+    }
+
+    _ands.emplace_back( a, b );
+    return 2u * _next_var++;
+  }
+
+  uint32_t create_or( uint32_t a, uint32_t b )
+  {
+    return create_and( a ^ 1u, b ^ 1u ) ^ 1u;
+  }
+
+  uint32_t create_xor( uint32_t a, uint32_t b )
+  {
+    const auto t1 = create_and( a, b ^ 1u );
+    const auto t2 = create_and( a ^ 1u, b );
+    return create_or( t1, t2 );
+  }
+
+  uint32_t create_maj( uint32_t a, uint32_t b, uint32_t c )
+  {
+    const auto t1 = create_and( a, b );
+    const auto t2 = create_or( a, b );
+    const auto t3 = create_and( c, t2 );
+    return create_or( t1, t3 );
+  }
+
+  uint32_t create_xor3( uint32_t a, uint32_t b, uint32_t c )
+  {
+    const auto t = create_xor( a, b );
+    return create_xor( t, c );
+  }
+
+  uint32_t max_var() const
+  {
+    return _next_var - 1u;
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> const& ands() const
+  {
+    return _ands;
+  }
+
+private:
+  uint32_t _next_var;
+  bool _strash;
+  std::vector<std::pair<uint32_t, uint32_t>> _ands;
+  std::unordered_map<uint64_t, uint32_t> _hash;
+};
+
+/* Output buffer that flushes to a stream in large blocks */
+class aiger_buffer
+{
+public:
+  explicit aiger_buffer( std::ostream& os ) : _os( os )
+  {
+    _buffer.reserve( block_size + 32u );
+  }
+
+  ~aiger_buffer()
+  {
+    flush();
+  }
+
+  void put( char c )
+  {
+    _buffer.push_back( c );
+    if ( _buffer.size() >= block_size )
+    {
+      flush();
+    }
+  }
+
+  void put( std::string const& s )
+  {
+    for ( auto c : s )
+    {
+      put( c );
+    }
+  }
+
+  void put_uint( uint32_t value )
+  {
+    char digits[10];
+    auto i = 0u;
+    do
+    {
+      digits[i++] = static_cast<char>( '0' + value % 10u );
+      value /= 10u;
+    } while ( value != 0u );
+    while ( i > 0u )
+    {
+      put( digits[--i] );
+    }
+  }
+
+  /* variable-length 7-bit encoding of binary AIGER deltas */
+  void put_delta( uint32_t value )
+  {
+    while ( value & ~0x7fu )
+    {
+      put( static_cast<char>( ( value & 0x7fu ) | 0x80u ) );
+      value >>= 7u;
+    }
+    put( static_cast<char>( value ) );
+  }
+
+  void flush()
+  {
+    _os.write( _buffer.data(), _buffer.size() );
+    _buffer.clear();
+  }
+
+private:
+  static constexpr std::size_t block_size = 1u << 16u;
+
+  std::ostream& _os;
+  std::vector<char> _buffer;
+};
+
+} // namespace detail
+
+/* Adds the gates of a network to an AIGER builder
+ *
+ * Gates with two fanins are added as AND gates, unless they are XOR gates,
+ * and gates with three fanins as majority gates, unless they are XOR3 gates.
+ * pis[i] is the literal of input i, and the literals of the outputs are
+ * returned.
+ */
+template<class Ntk>
+std::vector<uint32_t> add_to_aiger_builder( Ntk const& ntk, detail::aiger_builder& builder, std::vector<uint32_t> const& pis )
+{
+  std::vector<uint32_t> literals( ntk.size(), 0u );
+  ntk.foreach_pi( [&]( auto const& n, auto i ) {
+    literals[ntk.node_to_index( n )] = pis[i];
+  } );
+
+  const auto literal = [&]( auto const& f ) {
+    return literals[ntk.node_to_index( ntk.get_node( f ) )] ^ ( ntk.is_complemented( f ) ? 1u : 0u );
+  };
+
+  ntk.foreach_gate( [&]( auto const& n ) {
+    std::array<uint32_t, 3> fanins;
+    auto num_fanins = 0u;
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      fanins[num_fanins++] = literal( f );
+    } );
+
+    auto& lit = literals[ntk.node_to_index( n )];
+    if ( num_fanins == 2u )
+    {
+      bool is_xor{false};
+      if constexpr ( mockturtle::has_is_xor_v<Ntk> )
+      {
+        is_xor = ntk.is_xor( n );
+      }
+      lit = is_xor ? builder.create_xor( fanins[0], fanins[1] ) : builder.create_and( fanins[0], fanins[1] );
+    }
+    else
+    {
+      bool is_xor3{false};
+      if constexpr ( mockturtle::has_is_xor3_v<Ntk> )
+      {
+        is_xor3 = ntk.is_xor3( n );
+      }
+      lit = is_xor3 ? builder.create_xor3( fanins[0], fanins[1], fanins[2] ) : builder.create_maj( fanins[0], fanins[1], fanins[2] );
+    }
+  } );
+
+  std::vector<uint32_t> outputs;
+  outputs.reserve( ntk.num_pos() );
+  ntk.foreach_po( [&]( auto const& f ) {
+    outputs.push_back( literal( f ) );
+  } );
+  return outputs;
+}
+
+/* Writes a combinational network in AIGER format
+ *
+ * XOR, majority, and XOR3 gates are decomposed into ANDs as in
+ * add_to_aiger_builder.  The binary format is written unless ascii is set.
+ */
+template<class Ntk>
+void write_aiger( Ntk const& ntk, std::ostream& os, bool ascii = false )
+{
+  detail::aiger_builder builder( ntk.num_pis() );
+
+  std::vector<uint32_t> pis( ntk.num_pis() );
+  for ( auto i = 0u; i < pis.size(); ++i )
+  {
+    pis[i] = 2u * ( i + 1u );
+  }
+  const auto outputs = add_to_aiger_builder( ntk, builder, pis );
+
+  detail::aiger_buffer buffer( os );
+  buffer.put( ascii ? "aag " : "aig " );
+  buffer.put_uint( builder.max_var() );
+  buffer.put( ' ' );
+  buffer.put_uint( ntk.num_pis() );
+  buffer.put( " 0 " );
+  buffer.put_uint( ntk.num_pos() );
+  buffer.put( ' ' );
+  buffer.put_uint( static_cast<uint32_t>( builder.ands().size() ) );
+  buffer.put( '\n' );
+
+  if ( ascii )
+  {
+    for ( auto i = 1u; i <= ntk.num_pis(); ++i )
+    {
+      buffer.put_uint( 2u * i );
+      buffer.put( '\n' );
+    }
+  }
+
+  for ( auto lit : outputs )
+  {
+    buffer.put_uint( lit );
+    buffer.put( '\n' );
+  }
+
+  auto lhs = 2u * ( ntk.num_pis() + 1u );
+  for ( auto const& [rhs0, rhs1] : builder.ands() )
+  {
+    if ( ascii )
+    {
+      buffer.put_uint( lhs );
+      buffer.put( ' ' );
+      buffer.put_uint( rhs0 );
+      buffer.put( ' ' );
+      buffer.put_uint( rhs1 );
+      buffer.put( '\n' );
+    }
+    else
+    {
+      buffer.put_delta( lhs - rhs0 );
+      buffer.put_delta( rhs0 - rhs1 );
+    }
+    lhs += 2u;
+  }
+}
+
+/* Writes ASCII AIGER if the filename ends with .aag and binary AIGER otherwise */
+template<class Ntk>
+void write_aiger( Ntk const& ntk, std::string const& filename )
+{
+  const auto ascii = filename.size() >= 4u && filename.compare( filename.size() - 4u, 4u, ".aag" ) == 0;
+  std::ofstream os( filename, std::ofstream::out | std::ofstream::binary );
+  write_aiger( ntk, os, ascii );
+}
+
+} // namespace cirkit
@@ -64,6 +64,59 @@ struct tuple_to_cli<std::tuple<S...>>
   using type = alice::cli<S...>;
 };
 
+/* flat network exchange in the C interface, dispatched on the store option */
+template<typename StoreType>
+bool export_flat_network_from( environment::ptr const& env, std::string const& option, flat_network& flat, int& result )
+{
+  if ( option != store_info<StoreType>::option )
+  {
+    return false;
+  }
+
+  auto const& store = env->store<StoreType>();
+  if ( !can_exchange_flat_network<StoreType>() || store.current_index() == -1 )
+  {
+    return true;
+  }
+  export_flat_network<StoreType>( store.current(), flat );
+  result = 0;
+  return true;
+}
+
+template<typename StoreType>
+bool import_flat_network_into( environment::ptr const& env, std::string const& option, alice_flat_network const& network, int& result )
+{
+  if ( option != store_info<StoreType>::option )
+  {
+    return false;
+  }
+
+  if ( !can_exchange_flat_network<StoreType>() )
+  {
+    return true;
+  }
+  auto element = import_flat_network<StoreType>( network );
+  env->store<StoreType>().extend() = element;
+  result = 0;
+  return true;
+}
+
+template<typename... S>
+int export_flat_network_any( cli<S...>& cli, std::string const& option, flat_network& flat )
+{
+  auto result = -1;
+  ( export_flat_network_from<S>( cli.env, option, flat, result ) || ... );
+  return result;
+}
+
+template<typename... S>
+int import_flat_network_any( cli<S...>& cli, std::string const& option, alice_flat_network const& network )
+{
+  auto result = -1;
+  ( import_flat_network_into<S>( cli.env, option, network, result ) || ... );
+  return result;
+}
+
 template<typename T, int N>
 struct list_maker_key : list_maker_key<T, N - 1> {};
 
@@ -190,6 +243,48 @@ struct make_special_write_commands<CLI, Tuple, 0>
 {
   make_special_write_commands( CLI& cli, py::module& m ) {}
 };
+
+template<typename StoreType>
+bool export_words_from( environment::ptr const& env, std::string const& option, py::object& result )
+{
+  if ( option != store_info<StoreType>::option )
+  {
+    return false;
+  }
+
+  auto const& store = env->store<StoreType>();
+  if ( can_export_words<StoreType>() && store.current_index() != -1 )
+  {
+    result = detail::words_to_python( export_words<StoreType>( store.current() ) );
+  }
+  return true;
+}
+
+/* functions that return the current element of a store as NumPy arrays */
+template<typename... S>
+void make_store_buffer_functions( cli<S...>& cli, py::module& m )
+{
+  auto env = cli.env;
+
+  m.def( "store_words", [env]( std::string const& store ) -> py::object {
+    py::object result = py::none();
+    ( export_words_from<S>( env, store, result ) || ... );
+    return result;
+  },
+         "returns the current element of a store as a matrix of 64-bit words", py::arg( "store" ) );
+
+  m.def( "store_network", [env]( std::string const& store ) -> py::object {
+    flat_network flat;
+    auto result = -1;
+    ( export_flat_network_from<S>( env, store, flat, result ) || ... );
+    if ( result != 0 )
+    {
+      return py::none();
+    }
+    return py::cast( std::move( flat ) );
+  },
+         "returns the current network of a store as flat arrays", py::arg( "store" ) );
+}
 #endif
 
 /*! \brief Returns a one-line string to show when printing store contents
@@ -251,6 +346,86 @@ inline void print_statistics<type>( std::ostream& os, type const& element )
 template<> \
 inline nlohmann::json log_statistics<type>( type const& element )
 
+/*! \brief Writes a store element into a session snapshot
+
+  This macro adds an implementation for saving store elements with the
+  ``save_session`` command.  It must be combined with
+  :c:macro:`ALICE_DESERIALIZE_STORE` for the same store type.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param element Reference to the store element
+  \param out Reference to an ``alice::binary_writer``
+*/
+#define ALICE_SERIALIZE_STORE(type, element, out) \
+template<> \
+inline bool can_serialize<type>() { return true; } \
+template<> \
+inline void serialize<type>( type const& element, binary_writer& out )
+
+/*! \brief Reads a store element from a session snapshot
+
+  This macro adds an implementation for loading store elements with the
+  ``load_session`` command.  The body must return a store element.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param in Reference to an ``alice::binary_reader``
+*/
+#define ALICE_DESERIALIZE_STORE(type, in) \
+template<> \
+inline type deserialize<type>( binary_reader& in )
+
+/*! \brief Exports a store element as 64-bit words
+
+  This macro adds an implementation for returning store elements as NumPy
+  arrays in the Python bindings.
+
+  The macro must be followed by a code block that returns an
+  ``alice::word_matrix``.
+
+  \param type Store type
+  \param element Reference to the store element
+*/
+#define ALICE_EXPORT_WORDS(type, element) \
+template<> \
+inline bool can_export_words<type>() { return true; } \
+template<> \
+inline word_matrix export_words<type>( type const& element )
+
+/*! \brief Exports a store element into flat arrays
+
+  This macro adds an implementation for exporting store elements through the
+  C interface.  It must be combined with :c:macro:`ALICE_IMPORT_FLAT_NETWORK`
+  for the same store type.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param element Reference to the store element
+  \param flat Reference to an ``alice::flat_network``
+*/
+#define ALICE_EXPORT_FLAT_NETWORK(type, element, flat) \
+template<> \
+inline bool can_exchange_flat_network<type>() { return true; } \
+template<> \
+inline void export_flat_network<type>( type const& element, flat_network& flat )
+
+/*! \brief Creates a store element from flat arrays
+
+  The body must return a store element.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param network Reference to an ``alice_flat_network``
+*/
+#define ALICE_IMPORT_FLAT_NETWORK(type, network) \
+template<> \
+inline type import_flat_network<type>( alice_flat_network const& network )
+
 /*! \brief Read from a file into a store
 
   This macro adds an implementation for reading from a file into a store.
@@ -530,6 +705,7 @@ PYBIND11_MODULE(prefix, m) \
   _ALICE_MAIN_BODY(prefix) \
   alice::detail::create_python_module( cli, m ); \
   make_special_write_commands<cli_t, alice_write_tags, std::tuple_size<alice_write_tags>::value> swc( cli, m ); \
+  make_store_buffer_functions( cli, m ); \
 }
 #elif defined ALICE_CINTERFACE
 #ifdef _MSC_VER
@@ -580,6 +756,41 @@ extern "C" { \
     } \
     return -1; \
   } \
+  \
+  DLLEXPORT int prefix##_export_network( void* p, const char* store, alice_flat_network* network, void** handle ) { \
+    auto cli = reinterpret_cast<cli_t*>( p ); \
+    auto flat = new alice::flat_network(); \
+    try \
+    { \
+      if ( export_flat_network_any( *cli, store, *flat ) == 0 ) \
+      { \
+        *network = flat->view(); \
+        *handle = reinterpret_cast<void*>( flat ); \
+        return 0; \
+      } \
+    } \
+    catch ( ... ) \
+    { \
+    } \
+    delete flat; \
+    return -1; \
+  } \
+  \
+  DLLEXPORT int prefix##_import_network( void* p, const char* store, const alice_flat_network* network ) { \
+    auto cli = reinterpret_cast<cli_t*>( p ); \
+    try \
+    { \
+      return import_flat_network_any( *cli, store, *network ); \
+    } \
+    catch ( ... ) \
+    { \
+      return -1; \
+    } \
+  } \
+  \
+  DLLEXPORT void prefix##_release_network( void* handle ) { \
+    delete reinterpret_cast<alice::flat_network*>( handle ); \
+  } \
 }
 #else
 /*! \brief Alice main routine
@@ -596,6 +807,7 @@ extern "C" { \
   \param prefix Shell prefix or python module name (depending on mode)
  */
 #define ALICE_MAIN(prefix) \
+ALICE_ALLOCATION_HOOKS \
 int main( int argc, char ** argv ) \
 { \
   _ALICE_MAIN_BODY(prefix) \
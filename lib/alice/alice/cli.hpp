@@ -34,8 +34,9 @@
 
 #include <chrono>
 #include <fstream>
+#include <iostream>
 #include <memory>
-#include <regex>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,8 @@
 
 #include "command.hpp"
 #include "detail/logging.hpp"
+#include "detail/profiling.hpp"
+#include "detail/server.hpp"
 #include "readline.hpp"
 
 #include "commands/alias.hpp"
@@ -54,9 +57,11 @@
 #include "commands/ps.hpp"
 #include "commands/quit.hpp"
 #include "commands/read_io.hpp"
+#include "commands/session.hpp"
 #include "commands/set.hpp"
 #include "commands/show.hpp"
 #include "commands/store.hpp"
+#include "commands/undo.hpp"
 #include "commands/write_io.hpp"
 
 namespace alice
@@ -86,7 +91,8 @@ public:
   explicit cli( const std::string& prefix )
       : env( std::make_shared<environment>() ),
         prefix( prefix ),
-        opts( std::make_shared<CLI::App>() )
+        opts( std::make_shared<CLI::App>() ),
+        history( std::make_shared<detail::store_history<S...>>( env ) )
   {
     /* for each type in S ... */
     []( ... ) {}( ( env->add_store<S>(), 0 )... );
@@ -101,10 +107,14 @@ public:
     {
       insert_command( "convert", std::make_shared<convert_command<S...>>( env ) );
       insert_command( "current", std::make_shared<current_command<S...>>( env ) );
+      insert_command( "load_session", std::make_shared<load_session_command<S...>>( env ) );
       insert_command( "print", std::make_shared<print_command<S...>>( env ) );
       insert_command( "ps", std::make_shared<ps_command<S...>>( env ) );
+      insert_command( "save_session", std::make_shared<save_session_command<S...>>( env ) );
       insert_command( "show", std::make_shared<show_command<S...>>( env ) );
       insert_command( "store", std::make_shared<store_command<S...>>( env ) );
+      insert_command( "undo", std::make_shared<undo_command<S...>>( env, history ) );
+      insert_command( "redo", std::make_shared<redo_command<S...>>( env, history ) );
     }
 
     opts->add_option( "-c,--command", command, "process semicolon-separated list of commands" );
@@ -113,6 +123,11 @@ public:
     opts->add_flag( "-n,--counter", "show a counter in the prefix" );
     opts->add_flag( "-i,--interactive", "continue in interactive mode after processing commands (in command or file mode)" );
     opts->add_option( "-l,--log", logname, "logs the execution and stores many statistical information" );
+    opts->add_option( "--log_format", log_format, "log format in {json, jsonl, cbor, msgpack} (default: from file extension, otherwise json)" );
+    opts->add_option( "--log_flush", log_flush, "flush the log in the background every this many milliseconds instead of after each command" );
+    opts->add_flag( "--profile", "print resource usage of each command and count allocations" );
+    opts->add_flag( "--server", "serve JSON-RPC requests, one per line, on standard input (after processing -c or -f)" );
+    opts->add_option( "--socket", socket_path, "serve requests on this Unix domain socket instead of standard input" );
   }
 
   /*! \brief Sets the current category
@@ -214,8 +229,32 @@ public:
 
     if ( opts->count( "-l" ) )
     {
+      auto format = detail::log_format::json;
+      if ( opts->count( "--log_format" ) )
+      {
+        if ( !detail::parse_log_format( log_format, format ) )
+        {
+          env->err() << "[e] unknown log format " << log_format << std::endl;
+          return 2;
+        }
+      }
+      else
+      {
+        detail::parse_log_format( logname.substr( logname.find_last_of( '.' ) + 1u ), format );
+      }
+
+      if ( !env->logger.start( logname, format, log_flush ) )
+      {
+        env->err() << "[e] cannot open log file " << logname << std::endl;
+        return 2;
+      }
       env->log = true;
-      env->logger.start( logname );
+    }
+
+    if ( opts->count( "--profile" ) )
+    {
+      profile = true;
+      detail::allocation_counter().enabled = true;
     }
 
     if ( opts->count( "-c" ) )
@@ -247,12 +286,22 @@ public:
     {
       process_file( file, opts->count( "-e" ) );
 
-      if ( !opts->count( "-i" ) )
+      if ( !opts->count( "-i" ) && !opts->count( "--server" ) )
       {
         env->quit = true;
       }
     }
 
+    if ( opts->count( "--server" ) )
+    {
+      const auto code = env->quit ? 0 : serve();
+      if ( env->log )
+      {
+        env->logger.stop();
+      }
+      return code;
+    }
+
     if ( ( !opts->count( "-c" ) && !opts->count( "-f" ) ) || ( !env->quit && opts->count( "-i" ) ) )
     {
       auto& rl = readline_wrapper::instance();
@@ -338,12 +387,39 @@ private:
     const auto it = env->commands().find( vline.front() );
     if ( it != env->commands().end() )
     {
+      /* store elements are shared with the snapshot, see store_history */
+      const auto record = sizeof...( S ) > 0u && vline.front() != "undo" && vline.front() != "redo" && history->limit() > 0u;
+      auto before = record ? history->capture() : typename detail::store_history<S...>::snapshot{};
+
+      const auto measure = env->log || profile;
+      const nlohmann::json sizes_before = measure ? store_sizes() : nlohmann::json();
+      const auto usage_before = measure ? detail::current_resource_usage() : detail::resource_usage();
+
       const auto now = std::chrono::system_clock::now();
       const auto result = it->second->run( vline );
 
+      const nlohmann::json usage = measure ? resource_usage_since( usage_before, sizes_before ) : nlohmann::json();
+
+      if ( result && record )
+      {
+        history->record( std::move( before ) );
+      }
+
+      if ( result && collect_logs )
+      {
+        collected_logs.push_back( {{"command", line}, {"log", it->second->log()}} );
+      }
+
+      if ( profile )
+      {
+        env->out() << fmt::format( "[i] {}: time = {:.2f} s   cpu = {:.2f} s   peak RSS delta = {} KiB   allocations = {} ({} bytes)\n",
+                                   vline.front(), usage["wall_time"].get<double>(), usage["cpu_time"].get<double>(), usage["peak_rss_delta"].get<uint64_t>(),
+                                   usage["allocations"].get<uint64_t>(), usage["allocated_bytes"].get<uint64_t>() );
+      }
+
       if ( result && env->log )
       {
-        env->logger.log( it->second->log(), line, now );
+        env->logger.log( it->second->log(), line, now, usage );
       }
 
       return result;
@@ -357,6 +433,182 @@ private:
     return true;
   }
 
+  int serve()
+  {
+    const auto dispatch = [this]( const std::string& method, const nlohmann::json& params ) { return dispatch_request( method, params ); };
+    const auto done = [this]() { return env->quit; };
+
+    if ( opts->count( "--socket" ) )
+    {
+#ifdef _WIN32
+      env->err() << "[e] Unix domain sockets are not supported on Windows" << std::endl;
+      return 2;
+#else
+      std::string error;
+      if ( !detail::serve_unix_socket( socket_path, dispatch, done, error ) )
+      {
+        env->err() << "[e] " << error << std::endl;
+        return 2;
+      }
+#endif
+    }
+    else
+    {
+      detail::serve_stream( std::cin, std::cout, dispatch, done );
+    }
+    return 0;
+  }
+
+  /* Methods of the server protocol
+   *
+   * - execute: runs params.command (which may contain several commands
+   *   separated by semicolons and aliases) and returns the status, the log of
+   *   each executed command (unless params.log is false), the text output
+   *   (unless params.output is false), and the store sizes (if params.stores
+   *   is true)
+   * - stores: returns the store sizes
+   * - shutdown: stops the server
+   */
+  nlohmann::json dispatch_request( const std::string& method, const nlohmann::json& params )
+  {
+    if ( method == "execute" )
+    {
+      if ( !params.is_object() || !params.count( "command" ) || !params["command"].is_string() )
+      {
+        throw detail::rpc_error{detail::rpc_invalid_params, "expected string parameter command"};
+      }
+      return server_execute( params["command"].get<std::string>(), bool_param( params, "log", true ), bool_param( params, "output", true ), bool_param( params, "stores", false ) );
+    }
+    else if ( method == "stores" )
+    {
+      return store_sizes();
+    }
+    else if ( method == "shutdown" )
+    {
+      env->quit = true;
+      return nullptr;
+    }
+
+    throw detail::rpc_error{detail::rpc_method_not_found, "Method not found"};
+  }
+
+  static bool bool_param( const nlohmann::json& params, const std::string& key, bool default_value )
+  {
+    if ( !params.count( key ) )
+    {
+      return default_value;
+    }
+    if ( !params[key].is_boolean() )
+    {
+      throw detail::rpc_error{detail::rpc_invalid_params, fmt::format( "expected boolean parameter {}", key )};
+    }
+    return params[key].get<bool>();
+  }
+
+  /* redirects env->out(), env->err(), std::cout, and std::cerr while alive */
+  class output_capture
+  {
+  public:
+    output_capture( environment::ptr const& env, std::ostream& out, std::ostream& err )
+        : env( env ),
+          prev_out( env->out() ),
+          prev_err( env->err() ),
+          cout_buf( std::cout.rdbuf( out.rdbuf() ) ),
+          cerr_buf( std::cerr.rdbuf( err.rdbuf() ) )
+    {
+      env->reroute( out, err );
+    }
+
+    ~output_capture()
+    {
+      env->reroute( prev_out, prev_err );
+      std::cout.rdbuf( cout_buf );
+      std::cerr.rdbuf( cerr_buf );
+    }
+
+    output_capture( output_capture const& ) = delete;
+    output_capture& operator=( output_capture const& ) = delete;
+
+  private:
+    environment::ptr env;
+    std::ostream& prev_out;
+    std::ostream& prev_err;
+    std::streambuf* cout_buf;
+    std::streambuf* cerr_buf;
+  };
+
+  nlohmann::json server_execute( const std::string& line, bool with_log, bool with_output, bool with_stores )
+  {
+    /* capture output, also of code that writes to std::cout directly, which
+       would otherwise interfere with the protocol on standard output */
+    std::ostringstream out, err;
+    auto status = false;
+    {
+      output_capture capture( env, out, err );
+
+      collect_logs = with_log;
+      collected_logs = nlohmann::json::array();
+
+      try
+      {
+        auto trimmed = line;
+        detail::trim( trimmed );
+        status = execute_line( preprocess_alias( trimmed ) );
+      }
+      catch ( const std::exception& e )
+      {
+        err << "[e] " << e.what() << std::endl;
+      }
+      catch ( ... )
+      {
+        err << "[e] unknown exception" << std::endl;
+      }
+
+      collect_logs = false;
+    }
+
+    nlohmann::json result = {{"status", status}};
+    if ( with_log )
+    {
+      result["logs"] = std::move( collected_logs );
+    }
+    if ( with_output )
+    {
+      result["output"] = out.str();
+      result["error"] = err.str();
+    }
+    if ( with_stores )
+    {
+      result["stores"] = store_sizes();
+    }
+    return result;
+  }
+
+  nlohmann::json store_sizes() const
+  {
+    nlohmann::json sizes = nlohmann::json::object();
+    []( ... ) {}( ( sizes[store_info<S>::option] = env->store<S>().size(), 0 )... );
+    return sizes;
+  }
+
+  nlohmann::json resource_usage_since( detail::resource_usage const& before, nlohmann::json const& sizes_before ) const
+  {
+    const auto after = detail::current_resource_usage();
+    nlohmann::json usage = {
+        {"wall_time", std::chrono::duration<double>( after.wall - before.wall ).count()},
+        {"cpu_time", after.cpu - before.cpu},
+        {"peak_rss", after.peak_rss},
+        {"peak_rss_delta", after.peak_rss - before.peak_rss},
+        {"stores_before", sizes_before},
+        {"stores_after", store_sizes()}};
+    if ( profile )
+    {
+      usage["allocations"] = after.allocations - before.allocations;
+      usage["allocated_bytes"] = after.allocated_bytes - before.allocated_bytes;
+    }
+    return usage;
+  }
+
   bool process_file( const std::string& filename, bool echo, bool error_on_not_found = true )
   {
     std::ifstream in( filename.c_str(), std::ifstream::in );
@@ -427,22 +679,10 @@ private:
 
   std::string preprocess_alias( const std::string& line )
   {
-    std::smatch m;
-
-    for ( const auto& p : env->aliases() )
+    std::string expanded;
+    if ( env->alias_table().expand( line, expanded ) )
     {
-      if ( std::regex_match( line, m, std::regex( p.first ) ) )
-      {
-        std::vector<std::string> matches( m.size() - 1u );
-
-        for ( auto i = 0u; i < matches.size(); ++i )
-        {
-          matches[i] = std::string( m[i + 1] );
-        }
-
-        const auto str = detail::trim_copy( detail::format_with_vector( p.second, matches ) );
-        return preprocess_alias( str );
-      }
+      return preprocess_alias( expanded );
     }
 
     return line;
@@ -455,10 +695,17 @@ private:
   std::string prefix;
   std::shared_ptr<CLI::App> opts;
   std::string category;
+  std::shared_ptr<detail::store_history<S...>> history;
 
-  std::string command, file, logname;
+  std::string command, file, logname, log_format, socket_path;
+  unsigned log_flush{0u};
 
   unsigned counter{1u};
+  bool profile{false};
+
+  /* logs of executed commands in server mode */
+  bool collect_logs{false};
+  nlohmann::json collected_logs;
   /*! \endcond */
 };
 }
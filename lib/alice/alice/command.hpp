@@ -37,6 +37,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <CLI11.hpp>
@@ -44,11 +45,13 @@
 #include <fmt/format.h>
 #include <json.hpp>
 
+#include "detail/alias_table.hpp"
 #include "detail/logging.hpp"
 #include "detail/utils.hpp"
 #include "settings.hpp"
 #include "store.hpp"
 #include "store_api.hpp"
+#include "word_matrix.hpp"
 
 namespace alice
 {
@@ -150,6 +153,16 @@ public:
     return _aliases;
   }
 
+  /*! \brief Returns the compiled aliases
+
+    Same aliases as in ``aliases()`` with precompiled regular expressions, in
+    the order in which they have been defined.
+  */
+  inline const detail::alias_table& alias_table() const
+  {
+    return _alias_table;
+  }
+
   /*! \brief Get environment variable
 
     Finds an environment variable or returns a default value. Variables can be
@@ -248,6 +261,7 @@ private:
   std::unordered_map<std::string, std::shared_ptr<command>> _commands;
   std::unordered_map<std::string, std::vector<std::string>> _categories;
   std::unordered_map<std::string, std::string> _aliases;
+  detail::alias_table _alias_table;
   std::unordered_map<std::string, std::string> _variables;
   std::string _default_option;
 
@@ -363,6 +377,15 @@ public:
   */
   virtual nlohmann::json log() const { return nullptr; }
 
+  /*! \brief Returns bit-level results as matrices of 64-bit words
+
+    In Python mode, each matrix is added to the returned dictionary under its
+    key as a two-dimensional NumPy array.  This avoids converting large truth
+    tables or signatures into strings in ``log()``.  The words are not part of
+    the JSON log.
+  */
+  virtual std::vector<std::pair<std::string, word_matrix>> log_words() const { return {}; }
+
 public:
   /*! \brief Returns command short description */
   inline const auto& caption() const { return scaption; }
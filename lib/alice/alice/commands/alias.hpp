@@ -50,6 +50,15 @@ public:
 protected:
   void execute()
   {
+    try
+    {
+      env->_alias_table.insert( alias, expansion );
+    }
+    catch ( const std::exception& e )
+    {
+      env->err() << "[e] invalid alias " << alias << ": " << e.what() << std::endl;
+      return;
+    }
     env->_aliases[alias] = expansion;
   }
 
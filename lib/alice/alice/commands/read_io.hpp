@@ -32,7 +32,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <fmt/format.h>
@@ -73,11 +76,14 @@ protected:
 
   void execute()
   {
-    bool multiple{filenames.size() > 1};
+    std::vector<std::string> names;
     for ( const auto& filename : filenames )
     {
-      []( ... ) {}( read_io_helper<S>( multiple, detail::word_exp_filename( filename ) )... );
+      const auto expanded = detail::split( detail::word_exp_filename( filename ), " " );
+      names.insert( names.end(), expanded.begin(), expanded.end() );
     }
+
+    []( ... ) {}( read_io_helper<S>( names )... );
   }
 
 private:
@@ -96,35 +102,88 @@ private:
   }
 
   template<typename Store>
-  int read_io_helper( bool multiple, const std::string& filename )
+  struct read_result
+  {
+    bool success{false};
+    Store element;
+    std::string error;
+  };
+
+  template<typename Store>
+  void read_file( const std::string& name, read_result<Store>& result ) const
+  {
+    try
+    {
+      result.element = read<Store, Tag>( name, static_cast<command const&>( *this ) );
+      result.success = true;
+    }
+    catch ( const std::string& error )
+    {
+      result.error = error;
+    }
+    catch ( ... )
+    {
+      /* do nothing, user should display error or warning in `read` function */
+    }
+  }
+
+  template<typename Store>
+  int read_io_helper( const std::vector<std::string>& names )
   {
     constexpr auto option = store_info<Store>::option;
 
     if ( is_set( option ) || option == default_option || env->is_default_option( option ) )
     {
-      const auto names = detail::split( filename, " " );
+      /* files are parsed concurrently, but added to the store in the given order */
+      std::vector<read_result<Store>> results( names.size() );
+      const auto num_threads = std::min<std::size_t>( names.size(), std::max( 1u, std::thread::hardware_concurrency() ) );
 
-      for ( const auto& name : names )
+      if ( num_threads <= 1u )
       {
-        try
+        for ( auto i = 0u; i < names.size(); ++i )
         {
-          const auto element = read<Store, Tag>( name, static_cast<command const&>( *this ) );
-
-          if ( multiple || names.size() > 1 || is_set( "new" ) || env->store<Store>().empty() )
+          read_file<Store>( names[i], results[i] );
+        }
+      }
+      else
+      {
+        std::atomic<std::size_t> next{0u};
+        const auto worker = [&]() {
+          for ( auto i = next++; i < names.size(); i = next++ )
           {
-            env->store<Store>().extend();
+            read_file<Store>( names[i], results[i] );
           }
+        };
 
-          env->store<Store>().current() = element;
+        std::vector<std::thread> workers;
+        for ( auto t = 1u; t < num_threads; ++t )
+        {
+          workers.emplace_back( worker );
+        }
+        worker();
+        for ( auto& w : workers )
+        {
+          w.join();
         }
-        catch ( const std::string& error )
+      }
+
+      for ( auto& result : results )
+      {
+        if ( !result.success )
         {
-          env->err() << "[e] " << error << "\n";
+          if ( !result.error.empty() )
+          {
+            env->err() << "[e] " << result.error << "\n";
+          }
+          continue;
         }
-        catch ( ... )
+
+        if ( names.size() > 1 || is_set( "new" ) || env->store<Store>().empty() )
         {
-          /* do nothing, user should display error or warning in `read` function */
+          env->store<Store>().extend();
         }
+
+        env->store<Store>().current() = std::move( result.element );
       }
 
       env->set_default_option( option );
@@ -0,0 +1,272 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*
+  \file session.hpp
+  \brief Save and load all stores in a binary snapshot
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "../command.hpp"
+#include "../detail/mmap.hpp"
+#include "../serialization.hpp"
+
+namespace alice
+{
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* Session snapshot format (native byte order)
+ *
+ *   header:   "ALSS" version:u32 num_stores:u32
+ *   store:    key:string count:u32 current:i32
+ *   element:  size:u64 data:u8[size]
+ *
+ * Strings are prefixed with their length as u32.  Store elements are
+ * length-prefixed, such that stores that are unknown to the loading
+ * application can be skipped.
+ */
+constexpr char session_magic[4] = {'A', 'L', 'S', 'S'};
+constexpr uint32_t session_version = 1u;
+
+}
+/*! \endcond */
+
+template<class... S>
+class save_session_command : public command
+{
+public:
+  explicit save_session_command( const environment::ptr& env )
+      : command( env, "Saves all stores into a binary session snapshot" )
+  {
+    add_option( "filename,--filename", filename, "snapshot filename" )->required();
+  }
+
+protected:
+  void execute()
+  {
+    num_elements = 0u;
+
+    binary_writer out;
+    out.write_bytes( detail::session_magic, 4u );
+    out.write<uint32_t>( detail::session_version );
+    out.write<uint32_t>( static_cast<uint32_t>( ( 0u + ... + ( can_serialize<S>() ? 1u : 0u ) ) ) );
+    []( ... ) {}( save_store<S>( out )... );
+
+    /* the snapshot is replaced only after it has been written completely */
+    const auto tmp_filename = filename + ".tmp";
+    {
+      std::ofstream os( tmp_filename, std::ios::binary | std::ios::trunc );
+      os.write( out.buffer().data(), out.buffer().size() );
+      if ( !os.good() )
+      {
+        env->err() << fmt::format( "[e] could not write session file {}", filename ) << std::endl;
+        return;
+      }
+    }
+#ifdef _WIN32
+    std::remove( filename.c_str() );
+#endif
+    if ( std::rename( tmp_filename.c_str(), filename.c_str() ) != 0 )
+    {
+      env->err() << fmt::format( "[e] could not write session file {}", filename ) << std::endl;
+    }
+  }
+
+  nlohmann::json log() const
+  {
+    return {{"filename", filename}, {"elements", num_elements}};
+  }
+
+private:
+  template<typename Store>
+  int save_store( binary_writer& out )
+  {
+    const auto& _store = store<Store>();
+
+    if ( !can_serialize<Store>() )
+    {
+      if ( !_store.empty() )
+      {
+        env->err() << fmt::format( "[w] {} cannot be saved and are skipped", store_info<Store>::name_plural ) << std::endl;
+      }
+      return 0;
+    }
+
+    out.write_string( store_info<Store>::key );
+    out.write<uint32_t>( static_cast<uint32_t>( _store.size() ) );
+    out.write<int32_t>( _store.current_index() );
+
+    binary_writer element_out;
+    for ( const auto& element : _store.data() )
+    {
+      element_out.clear();
+      serialize<Store>( element, element_out );
+      out.write<uint64_t>( element_out.buffer().size() );
+      out.write_bytes( element_out.buffer().data(), element_out.buffer().size() );
+      ++num_elements;
+    }
+
+    return 0;
+  }
+
+private:
+  std::string filename;
+  uint32_t num_elements{0u};
+};
+
+template<class... S>
+class load_session_command : public command
+{
+public:
+  explicit load_session_command( const environment::ptr& env )
+      : command( env, "Loads all stores from a binary session snapshot" )
+  {
+    add_option( "filename,--filename", filename, "snapshot filename" )->required();
+  }
+
+protected:
+  void execute()
+  {
+    num_elements = 0u;
+
+    detail::mapped_file file( filename );
+    if ( !file.is_open() )
+    {
+      env->err() << fmt::format( "[e] could not open session file {}", filename ) << std::endl;
+      return;
+    }
+
+    /* all stores are decoded before any of them is replaced, such that a
+       corrupt snapshot leaves the environment unchanged */
+    std::vector<std::function<void()>> updates;
+    try
+    {
+      binary_reader in( file.begin(), file.end() );
+      if ( in.remaining() < 4u || std::memcmp( in.take( 4u ), detail::session_magic, 4u ) != 0 )
+      {
+        throw std::string( fmt::format( "[e] {} is not a session file", filename ) );
+      }
+      if ( const auto version = in.read<uint32_t>(); version != detail::session_version )
+      {
+        throw std::string( fmt::format( "[e] unsupported session file version {}", version ) );
+      }
+
+      const auto num_stores = in.read<uint32_t>();
+      for ( auto i = 0u; i < num_stores; ++i )
+      {
+        const auto key = in.read_string();
+        const auto count = in.read<uint32_t>();
+        const auto current = in.read<int32_t>();
+
+        std::vector<binary_reader> elements;
+        for ( auto j = 0u; j < count; ++j )
+        {
+          const auto size = in.read<uint64_t>();
+          const auto* data = in.take( size );
+          elements.emplace_back( data, data + size );
+        }
+
+        if ( !any_true_helper<bool>( {load_store<S>( key, elements, current, updates )...} ) )
+        {
+          env->err() << fmt::format( "[w] unknown store {} in session file is skipped", key ) << std::endl;
+        }
+      }
+    }
+    catch ( const std::string& e )
+    {
+      env->err() << e << std::endl;
+      return;
+    }
+
+    for ( const auto& update : updates )
+    {
+      update();
+    }
+  }
+
+  nlohmann::json log() const
+  {
+    return {{"filename", filename}, {"elements", num_elements}};
+  }
+
+private:
+  template<typename Store>
+  bool load_store( const std::string& key, std::vector<binary_reader>& elements, int32_t current, std::vector<std::function<void()>>& updates )
+  {
+    if ( key != store_info<Store>::key )
+    {
+      return false;
+    }
+
+    if ( !can_serialize<Store>() )
+    {
+      env->err() << fmt::format( "[w] {} cannot be loaded and are skipped", store_info<Store>::name_plural ) << std::endl;
+      return true;
+    }
+
+    auto data = std::make_shared<std::vector<Store>>();
+    data->reserve( elements.size() );
+    for ( auto& element_in : elements )
+    {
+      data->push_back( deserialize<Store>( element_in ) );
+    }
+    num_elements += static_cast<uint32_t>( data->size() );
+
+    updates.push_back( [this, data, current]() {
+      auto& _store = store<Store>();
+      _store.clear();
+      for ( auto& element : *data )
+      {
+        _store.extend() = std::move( element );
+      }
+      if ( current >= 0 )
+      {
+        _store.set_current_index( static_cast<unsigned>( current ) );
+      }
+    } );
+
+    return true;
+  }
+
+private:
+  std::string filename;
+  uint32_t num_elements{0u};
+};
+
+}
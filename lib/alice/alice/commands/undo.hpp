@@ -0,0 +1,282 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file undo.hpp
+  \brief Undo and redo changes to stores
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../command.hpp"
+#include "../serialization.hpp"
+
+namespace alice
+{
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+template<typename T, typename = void>
+struct has_equal_operator : std::false_type
+{
+};
+
+template<typename T>
+struct has_equal_operator<T, std::void_t<decltype( std::declval<T const&>() == std::declval<T const&>() )>> : std::true_type
+{
+};
+
+/* Elements are compared with operator==, which compares pointers for stores
+ * of shared pointers, or by their serialization.  Elements that can be
+ * neither compared nor serialized are considered different. */
+template<typename StoreType>
+bool store_elements_equal( StoreType const& a, StoreType const& b )
+{
+  if constexpr ( has_equal_operator<StoreType>::value )
+  {
+    return a == b;
+  }
+  else
+  {
+    if ( !can_serialize<StoreType>() )
+    {
+      return false;
+    }
+    binary_writer out_a, out_b;
+    serialize<StoreType>( a, out_a );
+    serialize<StoreType>( b, out_b );
+    return out_a.buffer() == out_b.buffer();
+  }
+}
+
+/* History of store contents for the undo and redo commands
+ *
+ * A snapshot copies the elements of all stores.  For stores of shared
+ * pointers, snapshots share the elements with the stores, such that a
+ * command that replaces a store element keeps the previous element alive
+ * without copying it.  Commands that modify a store element in place must
+ * therefore replace it by a copy first, if it is shared, i.e., if its use
+ * count is larger than one.
+ *
+ * Snapshots are only taken if the environment variable undo_limit is set to
+ * a positive number, which is the maximum number of commands that can be
+ * undone.
+ */
+template<class... S>
+class store_history
+{
+public:
+  using snapshot = std::tuple<std::pair<std::vector<S>, int>...>;
+
+  explicit store_history( const environment::ptr& env ) : env( env ) {}
+
+  uint32_t limit() const
+  {
+    try
+    {
+      return static_cast<uint32_t>( std::stoul( env->variable( "undo_limit", "0" ) ) );
+    }
+    catch ( ... )
+    {
+      return 0u;
+    }
+  }
+
+  snapshot capture() const
+  {
+    return snapshot{std::make_pair( env->store<S>().data(), env->store<S>().current_index() )...};
+  }
+
+  /* records the state before a command, if the command has changed any store */
+  void record( snapshot&& before )
+  {
+    if ( equal_to_stores( before, std::index_sequence_for<S...>{} ) )
+    {
+      return;
+    }
+
+    undo_stack.push_back( std::move( before ) );
+    redo_stack.clear();
+    while ( undo_stack.size() > limit() )
+    {
+      undo_stack.pop_front();
+    }
+  }
+
+  bool undo()
+  {
+    return move_snapshot( undo_stack, redo_stack );
+  }
+
+  bool redo()
+  {
+    return move_snapshot( redo_stack, undo_stack );
+  }
+
+  std::size_t num_undo() const
+  {
+    return undo_stack.size();
+  }
+
+  std::size_t num_redo() const
+  {
+    return redo_stack.size();
+  }
+
+private:
+  bool move_snapshot( std::deque<snapshot>& from, std::deque<snapshot>& to )
+  {
+    if ( from.empty() )
+    {
+      return false;
+    }
+    to.push_back( capture() );
+    restore( std::move( from.back() ), std::index_sequence_for<S...>{} );
+    from.pop_back();
+    return true;
+  }
+
+  template<std::size_t... I>
+  bool equal_to_stores( snapshot const& s, std::index_sequence<I...> ) const
+  {
+    return ( equal_to_store<S>( std::get<I>( s ) ) && ... );
+  }
+
+  template<typename StoreType>
+  bool equal_to_store( std::pair<std::vector<StoreType>, int> const& s ) const
+  {
+    auto const& store = env->store<StoreType>();
+    if ( s.second != store.current_index() || s.first.size() != store.size() )
+    {
+      return false;
+    }
+    for ( auto i = 0u; i < s.first.size(); ++i )
+    {
+      if ( !store_elements_equal<StoreType>( s.first[i], store.data()[i] ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<std::size_t... I>
+  void restore( snapshot&& s, std::index_sequence<I...> )
+  {
+    []( ... ) {}( ( restore_store<S>( std::move( std::get<I>( s ) ) ), 0 )... );
+  }
+
+  template<typename StoreType>
+  void restore_store( std::pair<std::vector<StoreType>, int>&& s )
+  {
+    auto& store = env->store<StoreType>();
+    store.clear();
+    for ( auto& element : s.first )
+    {
+      store.extend() = std::move( element );
+    }
+    if ( s.second >= 0 )
+    {
+      store.set_current_index( static_cast<unsigned>( s.second ) );
+    }
+  }
+
+private:
+  environment::ptr env;
+  std::deque<snapshot> undo_stack;
+  std::deque<snapshot> redo_stack;
+};
+
+}
+/*! \endcond */
+
+template<class... S>
+class undo_command : public command
+{
+public:
+  explicit undo_command( const environment::ptr& env, const std::shared_ptr<detail::store_history<S...>>& history )
+      : command( env, "Undoes the last command that changed a store (enable with `set undo_limit N`)" ),
+        history( history )
+  {
+  }
+
+protected:
+  void execute()
+  {
+    if ( !history->undo() )
+    {
+      env->err() << ( history->limit() == 0u ? "[w] undo history is disabled, use `set undo_limit N`" : "[w] nothing to undo" ) << std::endl;
+    }
+  }
+
+  nlohmann::json log() const
+  {
+    return nlohmann::json( {{"undo", history->num_undo()}, {"redo", history->num_redo()}} );
+  }
+
+private:
+  std::shared_ptr<detail::store_history<S...>> history;
+};
+
+template<class... S>
+class redo_command : public command
+{
+public:
+  explicit redo_command( const environment::ptr& env, const std::shared_ptr<detail::store_history<S...>>& history )
+      : command( env, "Redoes the last undone command" ),
+        history( history )
+  {
+  }
+
+protected:
+  void execute()
+  {
+    if ( !history->redo() )
+    {
+      env->err() << "[w] nothing to redo" << std::endl;
+    }
+  }
+
+  nlohmann::json log() const
+  {
+    return nlohmann::json( {{"undo", history->num_undo()}, {"redo", history->num_redo()}} );
+  }
+
+private:
+  std::shared_ptr<detail::store_history<S...>> history;
+};
+
+}
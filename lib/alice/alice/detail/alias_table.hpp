@@ -0,0 +1,156 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file alias_table.hpp
+  \brief Compiled command aliases
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "utils.hpp"
+
+namespace alice
+{
+
+namespace detail
+{
+
+/* Table of aliases with precompiled regular expressions
+ *
+ * Each alias is compiled once when it is defined.  For each alias the table
+ * keeps the literal prefix of its regular expression, i.e., the characters
+ * before the first special character, such that lines that do not start with
+ * the prefix are rejected without running the regular expression engine.
+ * Aliases without special characters, such as names of flows, are matched by
+ * string comparison and their expansion is computed once.  Aliases are tried
+ * in the order in which they have been defined; redefining an alias keeps
+ * its position.
+ */
+class alias_table
+{
+public:
+  /* adds or replaces an alias, throws std::regex_error for invalid expressions */
+  void insert( const std::string& alias, const std::string& expansion )
+  {
+    entry e{alias, literal_prefix( alias ), std::regex(), expansion, false};
+    e.literal = e.prefix.size() == alias.size();
+    if ( e.literal )
+    {
+      e.expansion = trim_copy( format_with_vector( expansion, {} ) );
+    }
+    else
+    {
+      e.regex = std::regex( alias, std::regex::optimize );
+    }
+
+    const auto it = std::find_if( _entries.begin(), _entries.end(), [&]( auto const& other ) { return other.alias == alias; } );
+    if ( it != _entries.end() )
+    {
+      *it = std::move( e );
+    }
+    else
+    {
+      _entries.push_back( std::move( e ) );
+    }
+  }
+
+  /* returns true and the expanded line, if the line matches an alias */
+  bool expand( const std::string& line, std::string& expanded ) const
+  {
+    std::smatch m;
+
+    for ( const auto& e : _entries )
+    {
+      if ( line.compare( 0u, e.prefix.size(), e.prefix ) != 0 )
+      {
+        continue;
+      }
+
+      if ( e.literal )
+      {
+        if ( line.size() == e.prefix.size() )
+        {
+          expanded = e.expansion;
+          return true;
+        }
+        continue;
+      }
+
+      if ( std::regex_match( line, m, e.regex ) )
+      {
+        std::vector<std::string> matches( m.size() - 1u );
+
+        for ( auto i = 0u; i < matches.size(); ++i )
+        {
+          matches[i] = std::string( m[i + 1] );
+        }
+
+        expanded = trim_copy( format_with_vector( e.expansion, matches ) );
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+private:
+  /* characters before the first special character, excluding a quantified one */
+  static std::string literal_prefix( const std::string& pattern )
+  {
+    if ( pattern.find( '|' ) != std::string::npos )
+    {
+      return std::string();
+    }
+
+    const std::string special = "^$\\.*+?()[]{}";
+    const auto pos = std::min( pattern.find_first_of( special ), pattern.size() );
+    if ( pos < pattern.size() && pos > 0u && std::string( "*+?{" ).find( pattern[pos] ) != std::string::npos )
+    {
+      return pattern.substr( 0u, pos - 1u );
+    }
+    return pattern.substr( 0u, pos );
+  }
+
+private:
+  struct entry
+  {
+    std::string alias;
+    std::string prefix;
+    std::regex regex;
+    std::string expansion;
+    bool literal;
+  };
+
+  std::vector<entry> _entries;
+};
+
+}
+}
@@ -33,10 +33,15 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -48,18 +53,103 @@ namespace alice
 namespace detail
 {
 
+enum class log_format
+{
+  json,    /* JSON array that is closed when logging stops */
+  jsonl,   /* one JSON object per line */
+  cbor,    /* sequence of CBOR encoded objects */
+  msgpack  /* sequence of MessagePack encoded objects */
+};
+
+/* log format from its name, which is also used as file extension */
+inline bool parse_log_format( const std::string& name, log_format& format )
+{
+  if ( name == "json" )
+  {
+    format = log_format::json;
+  }
+  else if ( name == "jsonl" )
+  {
+    format = log_format::jsonl;
+  }
+  else if ( name == "cbor" )
+  {
+    format = log_format::cbor;
+  }
+  else if ( name == "msgpack" )
+  {
+    format = log_format::msgpack;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+/* Streaming log writer
+ *
+ * Entries are written to the log file as soon as they are logged, such that
+ * memory does not grow with the number of commands and a crash only loses
+ * entries that have not been flushed yet.  Without a flush interval, every
+ * entry is flushed immediately; otherwise a background thread flushes the
+ * buffered stream periodically.  In JSON format the entries form an array,
+ * whose closing bracket is written when logging stops.
+ */
 class logger
 {
 public:
-  void start( const std::string& filename )
+  ~logger()
   {
-    _filename = filename;
+    stop();
   }
 
-  void log( const nlohmann::json& cmdlog, const std::string& cmdstring, const std::chrono::system_clock::time_point& start )
+  bool start( const std::string& filename, log_format format = log_format::json, unsigned flush_interval_ms = 0u )
+  {
+    stop();
+
+    _buffer.resize( 1u << 16u );
+    _os.rdbuf()->pubsetbuf( _buffer.data(), _buffer.size() );
+    _os.open( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+    if ( !_os.is_open() )
+    {
+      return false;
+    }
+
+    _format = format;
+    _num_entries = 0u;
+    if ( _format == log_format::json )
+    {
+      _os << "[";
+      _os.flush();
+    }
+
+    if ( flush_interval_ms != 0u )
+    {
+      _running = true;
+      _flusher = std::thread( [this, flush_interval_ms]() {
+        std::unique_lock<std::mutex> lock( _mutex );
+        while ( _running )
+        {
+          _cv.wait_for( lock, std::chrono::milliseconds( flush_interval_ms ) );
+          _os.flush();
+        }
+      } );
+    }
+
+    return true;
+  }
+
+  void log( const nlohmann::json& cmdlog, const std::string& cmdstring, const std::chrono::system_clock::time_point& start, const nlohmann::json& profile = nullptr )
   {
     auto obj = cmdlog;
 
+    /* add resource usage */
+    if ( !profile.is_null() )
+    {
+      obj["profile"] = profile;
+    }
+
     /* add command */
     obj["command"] = cmdstring;
 
@@ -70,18 +160,67 @@ public:
 
     obj["time"] = timestr;
 
-    array.push_back( obj );
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( !_os.is_open() )
+    {
+      return;
+    }
+
+    switch ( _format )
+    {
+    case log_format::json:
+      _os << ( _num_entries == 0u ? "\n" : ",\n" ) << obj;
+      break;
+    case log_format::jsonl:
+      _os << obj << "\n";
+      break;
+    case log_format::cbor:
+      nlohmann::json::to_cbor( obj, _os );
+      break;
+    case log_format::msgpack:
+      nlohmann::json::to_msgpack( obj, _os );
+      break;
+    }
+    ++_num_entries;
+
+    if ( !_flusher.joinable() )
+    {
+      _os.flush();
+    }
   }
 
   void stop()
   {
-    std::ofstream os( _filename.c_str(), std::ofstream::out );
-    os << array;
+    if ( _flusher.joinable() )
+    {
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _running = false;
+      }
+      _cv.notify_one();
+      _flusher.join();
+    }
+
+    if ( _os.is_open() )
+    {
+      if ( _format == log_format::json )
+      {
+        _os << ( _num_entries == 0u ? "]\n" : "\n]\n" );
+      }
+      _os.close();
+    }
   }
 
 private:
-  std::string _filename;
-  nlohmann::json array = nlohmann::json::array();
+  std::ofstream _os;
+  std::vector<char> _buffer;
+  log_format _format{log_format::json};
+  uint64_t _num_entries{0u};
+
+  std::thread _flusher;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _running{false};
 };
 
 }
@@ -0,0 +1,139 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file mmap.hpp
+  \brief Read-only memory-mapped files
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace alice
+{
+
+namespace detail
+{
+
+/*! \brief Maps a file into memory for reading
+
+  On POSIX systems the file is mapped with `mmap`, such that only the pages
+  that are accessed are read from disk.  On other systems the file contents
+  are read into a buffer.
+ */
+class mapped_file
+{
+public:
+  explicit mapped_file( const std::string& filename )
+  {
+#ifdef _WIN32
+    std::ifstream in( filename, std::ios::binary );
+    if ( !in.good() )
+    {
+      return;
+    }
+    _buffer.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+    _data = _buffer.data();
+    _size = _buffer.size();
+    _open = true;
+#else
+    const auto fd = ::open( filename.c_str(), O_RDONLY );
+    if ( fd == -1 )
+    {
+      return;
+    }
+
+    struct stat sb;
+    if ( ::fstat( fd, &sb ) == -1 )
+    {
+      ::close( fd );
+      return;
+    }
+
+    _size = static_cast<std::size_t>( sb.st_size );
+    if ( _size != 0u )
+    {
+      auto* addr = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if ( addr == MAP_FAILED )
+      {
+        ::close( fd );
+        _size = 0u;
+        return;
+      }
+      ::madvise( addr, _size, MADV_SEQUENTIAL );
+      _data = static_cast<const char*>( addr );
+    }
+
+    /* the mapping stays valid after the descriptor is closed */
+    ::close( fd );
+    _open = true;
+#endif
+  }
+
+  ~mapped_file()
+  {
+#ifndef _WIN32
+    if ( _data != nullptr )
+    {
+      ::munmap( const_cast<char*>( _data ), _size );
+    }
+#endif
+  }
+
+  mapped_file( const mapped_file& ) = delete;
+  mapped_file& operator=( const mapped_file& ) = delete;
+
+  bool is_open() const { return _open; }
+  const char* data() const { return _data; }
+  std::size_t size() const { return _size; }
+
+  const char* begin() const { return _data; }
+  const char* end() const { return _data + _size; }
+
+private:
+  bool _open{false};
+  const char* _data{nullptr};
+  std::size_t _size{0u};
+#ifdef _WIN32
+  std::vector<char> _buffer;
+#endif
+};
+
+} // namespace detail
+
+} // namespace alice
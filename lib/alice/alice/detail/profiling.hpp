@@ -0,0 +1,134 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file profiling.hpp
+  \brief Resource usage of commands
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace alice
+{
+
+namespace detail
+{
+
+/* Allocation counters
+ *
+ * The counters are only updated if counting is enabled and if the global
+ * allocation functions are replaced by ALICE_ALLOCATION_HOOKS, which is done
+ * in the main routine of stand-alone applications.
+ */
+struct allocation_counters
+{
+  std::atomic<bool> enabled{false};
+  std::atomic<uint64_t> allocations{0u};
+  std::atomic<uint64_t> bytes{0u};
+};
+
+inline allocation_counters& allocation_counter()
+{
+  static allocation_counters counters;
+  return counters;
+}
+
+inline void count_allocation( std::size_t size )
+{
+  auto& counters = allocation_counter();
+  if ( counters.enabled.load( std::memory_order_relaxed ) )
+  {
+    counters.allocations.fetch_add( 1u, std::memory_order_relaxed );
+    counters.bytes.fetch_add( size, std::memory_order_relaxed );
+  }
+}
+
+struct resource_usage
+{
+  std::chrono::steady_clock::time_point wall;
+  double cpu{0.0};       /* user and system time in seconds */
+  uint64_t peak_rss{0u}; /* in KiB, 0 if not available */
+  uint64_t allocations{0u};
+  uint64_t allocated_bytes{0u};
+};
+
+inline resource_usage current_resource_usage()
+{
+  resource_usage usage;
+  usage.wall = std::chrono::steady_clock::now();
+#ifdef _WIN32
+  usage.cpu = static_cast<double>( std::clock() ) / CLOCKS_PER_SEC;
+#else
+  struct rusage ru;
+  if ( getrusage( RUSAGE_SELF, &ru ) == 0 )
+  {
+    usage.cpu = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + ( ru.ru_utime.tv_usec + ru.ru_stime.tv_usec ) * 1e-6;
+#ifdef __APPLE__
+    usage.peak_rss = static_cast<uint64_t>( ru.ru_maxrss ) / 1024u; /* bytes on macOS */
+#else
+    usage.peak_rss = static_cast<uint64_t>( ru.ru_maxrss );
+#endif
+  }
+#endif
+  auto const& counters = allocation_counter();
+  usage.allocations = counters.allocations.load( std::memory_order_relaxed );
+  usage.allocated_bytes = counters.bytes.load( std::memory_order_relaxed );
+  return usage;
+}
+
+}
+}
+
+/*! \cond PRIVATE */
+#define ALICE_ALLOCATION_HOOKS \
+void* operator new( std::size_t size ) \
+{ \
+  alice::detail::count_allocation( size ); \
+  if ( auto* p = std::malloc( size ? size : 1u ) ) \
+  { \
+    return p; \
+  } \
+  throw std::bad_alloc(); \
+} \
+void operator delete( void* p ) noexcept \
+{ \
+  std::free( p ); \
+} \
+void operator delete( void* p, std::size_t ) noexcept \
+{ \
+  std::free( p ); \
+}
+/*! \endcond */
@@ -37,10 +37,13 @@
 #include <string>
 
 #include <fmt/format.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include "../command.hpp"
+#include "../flat_network.hpp"
+#include "../word_matrix.hpp"
 
 namespace py = pybind11;
 
@@ -109,6 +112,21 @@ py::object json_to_python( const nlohmann::json& json )
   }
 }
 
+/* moves the words into a NumPy array, which owns them through a capsule */
+inline py::object words_to_python( word_matrix&& matrix )
+{
+  auto words = new std::vector<uint64_t>( std::move( matrix.words ) );
+  py::capsule owner( words, []( void* p ) { delete reinterpret_cast<std::vector<uint64_t>*>( p ); } );
+  return py::array_t<uint64_t>( std::vector<std::size_t>{matrix.num_rows, matrix.num_columns}, words->data(), owner );
+}
+
+/* NumPy array over a vector of a flat network, which is kept alive by the array */
+template<typename T>
+py::array_t<T> flat_array( py::object const& self, std::vector<T> const& v )
+{
+  return py::array_t<T>( v.size(), v.data(), self );
+}
+
 class return_value_dict
 {
 public:
@@ -131,6 +149,11 @@ public:
     }
   }
 
+  void set( const std::string& key, py::object value )
+  {
+    _dict[py::str( key )] = value;
+  }
+
   py::object __getitem__( const std::string& key ) const
   {
     return _dict.attr( "__getitem__" )( py::str( key ) );
@@ -217,16 +240,32 @@ void create_python_module( CLI& cli, py::module& m )
       .def( "_repr_html_", &return_value_dict::_repr_html_ )
       .def( "dict", &return_value_dict::dict );
 
+  py::class_<flat_network> flat( m, "FlatNetwork" );
+  flat
+      .def_readonly( "num_pis", &flat_network::num_pis )
+      .def_property_readonly( "gate_types", []( py::object self ) { return flat_array( self, self.cast<flat_network const&>().gate_types ); } )
+      .def_property_readonly( "fanin_offsets", []( py::object self ) { return flat_array( self, self.cast<flat_network const&>().fanin_offsets ); } )
+      .def_property_readonly( "fanins", []( py::object self ) { return flat_array( self, self.cast<flat_network const&>().fanins ); } )
+      .def_property_readonly( "outputs", []( py::object self ) { return flat_array( self, self.cast<flat_network const&>().outputs ); } )
+      .def_property_readonly( "function_offsets", []( py::object self ) { return flat_array( self, self.cast<flat_network const&>().function_offsets ); } )
+      .def_property_readonly( "functions", []( py::object self ) { return flat_array( self, self.cast<flat_network const&>().functions ); } );
+
   for ( const auto& p : cli.env->commands() )
   {
     m.def( p.first.c_str(), [p]( py::kwargs kwargs ) -> py::object {
       p.second->run( make_args( p.first, kwargs ) );
 
       const auto log = p.second->log();
+      auto words = p.second->log_words();
 
-      if ( log.is_object() )
+      if ( log.is_object() || !words.empty() )
       {
-        return py::cast( return_value_dict( log ) );
+        return_value_dict dict( log.is_object() ? log : nlohmann::json::object() );
+        for ( auto& w : words )
+        {
+          dict.set( w.first, words_to_python( std::move( w.second ) ) );
+        }
+        return py::cast( std::move( dict ) );
       }
       else
       {
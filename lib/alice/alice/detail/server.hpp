@@ -0,0 +1,293 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file server.hpp
+  \brief JSON-RPC protocol for server mode
+*/
+
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include <json.hpp>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace alice
+{
+
+namespace detail
+{
+
+/* error that is reported to the client as JSON-RPC error object */
+struct rpc_error
+{
+  int code;
+  std::string message;
+};
+
+constexpr int rpc_parse_error = -32700;
+constexpr int rpc_invalid_request = -32600;
+constexpr int rpc_method_not_found = -32601;
+constexpr int rpc_invalid_params = -32602;
+constexpr int rpc_internal_error = -32603;
+
+using rpc_dispatcher = std::function<nlohmann::json( const std::string&, const nlohmann::json& )>;
+
+inline nlohmann::json rpc_error_response( const nlohmann::json& id, int code, const std::string& message )
+{
+  return {{"jsonrpc", "2.0"}, {"id", id}, {"error", {{"code", code}, {"message", message}}}};
+}
+
+/* handles one request object, returns null for notifications */
+inline nlohmann::json handle_rpc_request( const nlohmann::json& request, const rpc_dispatcher& dispatch )
+{
+  if ( !request.is_object() || !request.count( "method" ) || !request["method"].is_string() )
+  {
+    return rpc_error_response( nullptr, rpc_invalid_request, "Invalid Request" );
+  }
+
+  const auto is_notification = !request.count( "id" );
+  const auto id = is_notification ? nlohmann::json() : request["id"];
+  const auto params = request.count( "params" ) ? request["params"] : nlohmann::json::object();
+
+  nlohmann::json response;
+  try
+  {
+    response = {{"jsonrpc", "2.0"}, {"id", id}, {"result", dispatch( request["method"].get<std::string>(), params )}};
+  }
+  catch ( const rpc_error& e )
+  {
+    response = rpc_error_response( id, e.code, e.message );
+  }
+  catch ( const std::exception& e )
+  {
+    response = rpc_error_response( id, rpc_internal_error, std::string( "Internal error: " ) + e.what() );
+  }
+  catch ( ... )
+  {
+    response = rpc_error_response( id, rpc_internal_error, "Internal error" );
+  }
+
+  return is_notification ? nlohmann::json() : response;
+}
+
+/* Handles one line of the protocol
+ *
+ * A line contains either a single request or a batch, i.e., an array of
+ * requests, which are handled in order.  Returns the response line, which is
+ * empty if no response is due.
+ */
+inline std::string handle_rpc_line( const std::string& line, const rpc_dispatcher& dispatch )
+{
+  if ( line.find_first_not_of( " \t\r" ) == std::string::npos )
+  {
+    return std::string();
+  }
+
+  nlohmann::json request;
+  try
+  {
+    request = nlohmann::json::parse( line );
+  }
+  catch ( const std::exception& )
+  {
+    return rpc_error_response( nullptr, rpc_parse_error, "Parse error" ).dump();
+  }
+
+  if ( !request.is_array() )
+  {
+    const auto response = handle_rpc_request( request, dispatch );
+    return response.is_null() ? std::string() : response.dump();
+  }
+
+  if ( request.empty() )
+  {
+    return rpc_error_response( nullptr, rpc_invalid_request, "Invalid Request" ).dump();
+  }
+
+  auto responses = nlohmann::json::array();
+  for ( const auto& r : request )
+  {
+    const auto response = handle_rpc_request( r, dispatch );
+    if ( !response.is_null() )
+    {
+      responses.push_back( response );
+    }
+  }
+  return responses.empty() ? std::string() : responses.dump();
+}
+
+/* serves newline-delimited requests from a stream until the stream ends or done returns true */
+inline void serve_stream( std::istream& in, std::ostream& out, const rpc_dispatcher& dispatch, const std::function<bool()>& done )
+{
+  std::string line;
+  while ( !done() && std::getline( in, line ) )
+  {
+    const auto response = handle_rpc_line( line, dispatch );
+    if ( !response.empty() )
+    {
+      out << response << std::endl;
+    }
+  }
+}
+
+#ifndef _WIN32
+inline bool write_all( int fd, const std::string& data )
+{
+#ifdef MSG_NOSIGNAL
+  constexpr int flags = MSG_NOSIGNAL;
+#else
+  constexpr int flags = 0;
+#endif
+  std::size_t written{0u};
+  while ( written < data.size() )
+  {
+    const auto n = ::send( fd, data.data() + written, data.size() - written, flags );
+    if ( n < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( n <= 0 )
+    {
+      return false;
+    }
+    written += static_cast<std::size_t>( n );
+  }
+  return true;
+}
+
+/* Serves requests on a Unix domain socket
+ *
+ * Clients are served one after another, such that commands never run
+ * concurrently on the stores.  A stale socket at path is replaced, but any
+ * other existing file is left untouched.  The socket file is removed when
+ * serving stops.  Returns false and sets an error message if the socket cannot be
+ * created.
+ */
+inline bool serve_unix_socket( const std::string& path, const rpc_dispatcher& dispatch, const std::function<bool()>& done, std::string& error )
+{
+  sockaddr_un addr{};
+  if ( path.size() >= sizeof( addr.sun_path ) )
+  {
+    error = "socket path is too long";
+    return false;
+  }
+  addr.sun_family = AF_UNIX;
+  path.copy( addr.sun_path, path.size() );
+
+  struct stat st;
+  if ( ::lstat( path.c_str(), &st ) == 0 )
+  {
+    if ( !S_ISSOCK( st.st_mode ) )
+    {
+      error = path + " exists and is not a socket";
+      return false;
+    }
+    ::unlink( path.c_str() );
+  }
+
+  const auto fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  if ( fd < 0 )
+  {
+    error = "cannot create socket";
+    return false;
+  }
+#ifdef SO_NOSIGPIPE
+  const int on = 1;
+  ::setsockopt( fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof( on ) );
+#endif
+
+  if ( ::bind( fd, reinterpret_cast<sockaddr*>( &addr ), sizeof( addr ) ) != 0 || ::listen( fd, 4 ) != 0 )
+  {
+    ::close( fd );
+    error = "cannot bind socket " + path;
+    return false;
+  }
+
+  while ( !done() )
+  {
+    const auto client = ::accept( fd, nullptr, nullptr );
+    if ( client < 0 )
+    {
+      if ( errno == EINTR )
+      {
+        continue;
+      }
+      break;
+    }
+#ifdef SO_NOSIGPIPE
+    ::setsockopt( client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof( on ) );
+#endif
+
+    std::string pending;
+    char buffer[4096];
+    auto connected = true;
+    while ( connected && !done() )
+    {
+      const auto n = ::read( client, buffer, sizeof( buffer ) );
+      if ( n < 0 && errno == EINTR )
+      {
+        continue;
+      }
+      if ( n <= 0 )
+      {
+        break;
+      }
+      pending.append( buffer, static_cast<std::size_t>( n ) );
+
+      std::size_t begin{0u}, end;
+      while ( connected && !done() && ( end = pending.find( '\n', begin ) ) != std::string::npos )
+      {
+        const auto response = handle_rpc_line( pending.substr( begin, end - begin ), dispatch );
+        begin = end + 1u;
+        if ( !response.empty() )
+        {
+          connected = write_all( client, response + "\n" );
+        }
+      }
+      pending.erase( 0u, begin );
+    }
+    ::close( client );
+  }
+
+  ::close( fd );
+  ::unlink( path.c_str() );
+  return true;
+}
+#endif
+
+}
+}
@@ -104,7 +104,7 @@ inline std::string format_with_vector( const std::string& fmtstr, const std::vec
     data[i].string.size = values[i].size();
   }
 
-  return fmt::format( fmtstr, fmt::ArgList( types, &data[0] ) );
+  return fmt::format( fmtstr, fmt::ArgList( types, data.data() ) );
 }
 
 template<char sep>
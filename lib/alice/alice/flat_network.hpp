@@ -0,0 +1,109 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file flat_network.hpp
+  \brief Exchange of logic networks as flat arrays
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Logic network as flat arrays
+
+  This plain struct is used to exchange networks with C code without files or
+  serialization.  Nodes are numbered by ids, in which 0 and 1 are the
+  constants, followed by the primary inputs and the gates in topological
+  order.  Fanins and outputs are literals ``2 * id + complement``.
+
+  Gate ``i`` has the application-defined type ``gate_types[i]`` and the fanins
+  ``fanins[fanin_offsets[i]]`` to ``fanins[fanin_offsets[i + 1] - 1]``.  If
+  ``functions`` is not null, gate ``i`` has the truth table words
+  ``functions[function_offsets[i]]`` to
+  ``functions[function_offsets[i + 1] - 1]``.
+
+  The arrays are owned by the side that creates the struct and are only
+  borrowed by the other side.
+*/
+struct alice_flat_network
+{
+  uint32_t num_pis;
+  uint32_t num_gates;
+  uint32_t num_pos;
+  const uint32_t* gate_types;       /* num_gates entries */
+  const uint32_t* fanin_offsets;    /* num_gates + 1 entries */
+  const uint32_t* fanins;           /* fanin_offsets[num_gates] entries */
+  const uint32_t* outputs;          /* num_pos entries */
+  const uint32_t* function_offsets; /* num_gates + 1 entries or null */
+  const uint64_t* functions;        /* function_offsets[num_gates] entries or null */
+};
+
+namespace alice
+{
+
+/*! \brief Owner of the arrays of an exported network
+
+  Store elements are exported into this class, which keeps the arrays alive
+  while they are shared through ``view()``.
+*/
+struct flat_network
+{
+  uint32_t num_pis{0u};
+  std::vector<uint32_t> gate_types;
+  std::vector<uint32_t> fanin_offsets{0u};
+  std::vector<uint32_t> fanins;
+  std::vector<uint32_t> outputs;
+  std::vector<uint32_t> function_offsets{0u};
+  std::vector<uint64_t> functions;
+
+  /*! \brief Adds a gate with the given fanin literals and truth table words */
+  template<class Fanins, class Words = std::vector<uint64_t>>
+  void add_gate( uint32_t type, Fanins const& gate_fanins, Words const& words = Words() )
+  {
+    gate_types.push_back( type );
+    fanins.insert( fanins.end(), gate_fanins.begin(), gate_fanins.end() );
+    fanin_offsets.push_back( static_cast<uint32_t>( fanins.size() ) );
+    functions.insert( functions.end(), words.begin(), words.end() );
+    function_offsets.push_back( static_cast<uint32_t>( functions.size() ) );
+  }
+
+  /*! \brief Returns a view of the arrays, valid as long as this object is not modified */
+  alice_flat_network view() const
+  {
+    return {num_pis,
+            static_cast<uint32_t>( gate_types.size() ),
+            static_cast<uint32_t>( outputs.size() ),
+            gate_types.data(),
+            fanin_offsets.data(),
+            fanins.data(),
+            outputs.data(),
+            functions.empty() ? nullptr : function_offsets.data(),
+            functions.empty() ? nullptr : functions.data()};
+  }
+};
+
+}
@@ -0,0 +1,130 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file serialization.hpp
+  \brief Binary serialization of store elements
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace alice
+{
+
+/*! \brief Writes binary data into a growing buffer
+
+  Values are written in native byte order.  Session snapshots are therefore
+  only portable between machines with the same endianness.
+*/
+class binary_writer
+{
+public:
+  /*! \brief Writes a trivially copyable value */
+  template<typename T>
+  void write( T const& value )
+  {
+    static_assert( std::is_trivially_copyable<T>::value, "value must be trivially copyable" );
+    const auto* p = reinterpret_cast<const char*>( &value );
+    _buffer.insert( _buffer.end(), p, p + sizeof( T ) );
+  }
+
+  /*! \brief Writes a range of bytes */
+  void write_bytes( const char* data, std::size_t size )
+  {
+    _buffer.insert( _buffer.end(), data, data + size );
+  }
+
+  /*! \brief Writes a length-prefixed string */
+  void write_string( const std::string& s )
+  {
+    write<uint32_t>( static_cast<uint32_t>( s.size() ) );
+    write_bytes( s.data(), s.size() );
+  }
+
+  const std::vector<char>& buffer() const { return _buffer; }
+
+  void clear() { _buffer.clear(); }
+
+private:
+  std::vector<char> _buffer;
+};
+
+/*! \brief Reads binary data from a memory range
+
+  The reader does not own the memory, which typically is a memory-mapped
+  file.  All read functions throw a string if the range is exhausted.
+*/
+class binary_reader
+{
+public:
+  binary_reader( const char* begin, const char* end ) : _pos( begin ), _end( end ) {}
+
+  /*! \brief Reads a trivially copyable value */
+  template<typename T>
+  T read()
+  {
+    static_assert( std::is_trivially_copyable<T>::value, "value must be trivially copyable" );
+    T value;
+    std::memcpy( &value, take( sizeof( T ) ), sizeof( T ) );
+    return value;
+  }
+
+  /*! \brief Returns a pointer to the next size bytes and skips them */
+  const char* take( std::size_t size )
+  {
+    if ( remaining() < size )
+    {
+      throw std::string( "[e] unexpected end of binary data" );
+    }
+    const auto* p = _pos;
+    _pos += size;
+    return p;
+  }
+
+  /*! \brief Reads a length-prefixed string */
+  std::string read_string()
+  {
+    const auto size = read<uint32_t>();
+    const auto* p = take( size );
+    return std::string( p, p + size );
+  }
+
+  std::size_t remaining() const { return static_cast<std::size_t>( _end - _pos ); }
+
+  bool at_end() const { return _pos == _end; }
+
+private:
+  const char* _pos;
+  const char* _end;
+};
+
+}
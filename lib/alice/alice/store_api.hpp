@@ -39,6 +39,9 @@
 #include <json.hpp>
 
 #include "command.hpp"
+#include "flat_network.hpp"
+#include "serialization.hpp"
+#include "word_matrix.hpp"
 
 namespace alice
 {
@@ -270,6 +273,126 @@ void write( StoreType const& element, std::ostream& os, const command& cmd )
   throw std::runtime_error( "[e] unimplemented function" );
 }
 
+/*! \brief Controls whether store elements can be saved in session snapshots
+
+  If this function is overriden to return true, then also the functions
+  `serialize` and `deserialize` must be implemented for the same store type.
+  Stores for which this function returns false are skipped by the
+  `save_session` command.
+
+  \verbatim embed:rst
+      You can use :c:macro:`ALICE_SERIALIZE_STORE` to implement this function together with ``serialize``.
+  \endverbatim
+*/
+template<typename StoreType>
+bool can_serialize()
+{
+  return false;
+}
+
+/*! \brief Writes a store element into a session snapshot
+
+  This function must be enabled by overriding the `can_serialize` function for
+  the same store type.
+
+  \param element Store element to serialize
+  \param out Binary writer
+*/
+template<typename StoreType>
+void serialize( StoreType const& element, binary_writer& out )
+{
+  (void)element;
+  (void)out;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
+/*! \brief Reads a store element from a session snapshot
+
+  This function must read exactly the data that is written by `serialize` for
+  the same store type.  It may throw a string if the data is malformed.
+
+  \param in Binary reader over the element's data
+  \return Store element
+*/
+template<typename StoreType>
+StoreType deserialize( binary_reader& in )
+{
+  (void)in;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
+/*! \brief Controls whether store elements can be exported as 64-bit words
+
+  If this function is overriden to return true, then also the function
+  `export_words` must be implemented for the same store type.  It is used by
+  the Python bindings to return store elements as NumPy arrays.
+
+  \verbatim embed:rst
+      You can use :c:macro:`ALICE_EXPORT_WORDS` to implement both functions.
+  \endverbatim
+*/
+template<typename StoreType>
+bool can_export_words()
+{
+  return false;
+}
+
+/*! \brief Exports a store element as a matrix of 64-bit words
+
+  \param element Store element to export
+  \return Words of the element, e.g., one row with the blocks of a truth table
+*/
+template<typename StoreType>
+word_matrix export_words( StoreType const& element )
+{
+  (void)element;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
+/*! \brief Controls whether store elements can be exchanged as flat arrays
+
+  If this function is overriden to return true, then also the functions
+  `export_flat_network` and `import_flat_network` must be implemented for the
+  same store type.  They are used by the C interface.
+
+  \verbatim embed:rst
+      You can use :c:macro:`ALICE_EXPORT_FLAT_NETWORK` to implement this function together with ``export_flat_network``.
+  \endverbatim
+*/
+template<typename StoreType>
+bool can_exchange_flat_network()
+{
+  return false;
+}
+
+/*! \brief Exports a store element into flat arrays
+
+  \param element Store element to export
+  \param flat Owner of the arrays to fill
+*/
+template<typename StoreType>
+void export_flat_network( StoreType const& element, flat_network& flat )
+{
+  (void)element;
+  (void)flat;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
+/*! \brief Creates a store element from flat arrays
+
+  The arrays are borrowed from the caller and must not be kept.  The function
+  may throw a string if the arrays are malformed.
+
+  \param network View of the arrays
+  \return Store element
+*/
+template<typename StoreType>
+StoreType import_flat_network( alice_flat_network const& network )
+{
+  (void)network;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
 /*! \brief Controls whether a store entry can be converted to an entry of a different store type
 
   If this function is overriden to return true, then also the function
@@ -0,0 +1,62 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file word_matrix.hpp
+  \brief Matrices of 64-bit words
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace alice
+{
+
+/*! \brief Row-major matrix of 64-bit words
+
+  Used to pass bit-level data such as truth tables or simulation signatures
+  to the Python bindings without converting it into strings.  In Python, the
+  matrix becomes a two-dimensional NumPy array of type ``uint64`` that takes
+  over the words without copying them.
+*/
+struct word_matrix
+{
+  std::size_t num_rows{0u};
+  std::size_t num_columns{0u};
+  std::vector<uint64_t> words;
+
+  /*! \brief Appends a row, which must have ``num_columns`` words */
+  template<class Row>
+  void add_row( Row const& row )
+  {
+    words.insert( words.end(), row.begin(), row.end() );
+    ++num_rows;
+  }
+};
+
+}
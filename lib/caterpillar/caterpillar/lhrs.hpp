@@ -6,11 +6,14 @@
 #pragma once
 
 #include <array>
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <mockturtle/traits.hpp>
 #include <mockturtle/utils/node_map.hpp>
 #include <mockturtle/views/topo_view.hpp>
-#include <stack>
+#include <deque>
+#include <set>
 #include <tweedledum/gates/gate_kinds.hpp>
 #include <variant>
 #include <vector>
@@ -56,21 +59,24 @@ public:
 		std::unordered_set<mt::node<LogicNetwork>> drivers;
 		ntk.foreach_po([&](auto const& f) { drivers.insert(ntk.get_node(f)); });
 
-		auto it = steps.begin();
+		/* compute steps are in topological order and followed by the
+		 * uncompute steps in reverse order; both are collected separately
+		 * to avoid insertions into the middle of the step vector */
+		std::vector<step_type> uncompute_steps;
 		mt::topo_view view{ntk};
 		view.foreach_node([&](auto n) {
 			if (ntk.is_constant(n) || ntk.is_pi(n))
 				return true;
 
 			/* compute step */
-			it = steps.insert(it, {n, compute_action{}});
-			++it;
+			steps.emplace_back(n, compute_action{});
 
 			if (!drivers.count(n))
-				it = steps.insert(it, {n, uncompute_action{}});
+				uncompute_steps.emplace_back(n, uncompute_action{});
 
 			return true;
 		});
+		steps.insert(steps.end(), uncompute_steps.rbegin(), uncompute_steps.rend());
 	}
 
 	template<class Fn>
@@ -81,7 +87,8 @@ public:
 	}
 
 private:
-	std::vector<std::pair<mt::node<LogicNetwork>, mapping_strategy_action>> steps;
+	using step_type = std::pair<mt::node<LogicNetwork>, mapping_strategy_action>;
+	std::vector<step_type> steps;
 };
 
 template<class LogicNetwork>
@@ -109,7 +116,8 @@ public:
 		ntk.clear_values();
 		ntk.foreach_node([&](const auto& n) { ntk.set_value(n, ntk.fanout_size(n)); });
 
-		auto it = steps.begin();
+		/* see bennett_mapping_strategy */
+		std::vector<step_type> uncompute_steps;
 		//mt::topo_view view{ntk};
 		ntk.foreach_node([&](auto n) {
 			if (ntk.is_constant(n) || ntk.is_pi(n))
@@ -129,39 +137,29 @@ public:
 			if (target != -1 && !drivers.count(n)) {
 				if constexpr (mt::has_is_xor_v<LogicNetwork>) {
 					if (ntk.is_xor(n)) {
-						it = steps.insert(it, {n, compute_inplace_action{
-						                              static_cast<uint32_t>(
-						                                  target)}});
-						++it;
-						it = steps.insert(it, {n, uncompute_inplace_action{
-						                              static_cast<uint32_t>(
-						                                  target)}});
+						steps.emplace_back(n, compute_inplace_action{static_cast<uint32_t>(target)});
+						uncompute_steps.emplace_back(n, uncompute_inplace_action{static_cast<uint32_t>(target)});
 						return true;
 					}
 				}
 				if constexpr (mt::has_is_xor3_v<LogicNetwork>) {
 					if (ntk.is_xor3(n)) {
-						it = steps.insert(it, {n, compute_inplace_action{
-						                              static_cast<uint32_t>(
-						                                  target)}});
-						++it;
-						it = steps.insert(it, {n, uncompute_inplace_action{
-						                              static_cast<uint32_t>(
-						                                  target)}});
+						steps.emplace_back(n, compute_inplace_action{static_cast<uint32_t>(target)});
+						uncompute_steps.emplace_back(n, uncompute_inplace_action{static_cast<uint32_t>(target)});
 						return true;
 					}
 				}
 			}
 
 			/* compute step */
-			it = steps.insert(it, {n, compute_action{}});
-			++it;
+			steps.emplace_back(n, compute_action{});
 
 			if (!drivers.count(n))
-				it = steps.insert(it, {n, uncompute_action{}});
+				uncompute_steps.emplace_back(n, uncompute_action{});
 
 			return true;
 		});
+		steps.insert(steps.end(), uncompute_steps.rbegin(), uncompute_steps.rend());
 	}
 
 	template<class Fn>
@@ -172,11 +170,278 @@ public:
 	}
 
 private:
-	std::vector<std::pair<mt::node<LogicNetwork>, mapping_strategy_action>> steps;
+	using step_type = std::pair<mt::node<LogicNetwork>, mapping_strategy_action>;
+	std::vector<step_type> steps;
+};
+
+struct pebbling_mapping_strategy_params {
+	/*! \brief Maximum number of qubits, including the primary inputs (0 means no limit). */
+	uint32_t max_qubits{0};
+};
+
+/*! \brief Reversible pebbling strategy under a qubit budget
+ *
+ * Computes all output drivers such that at most `max_qubits` qubits are
+ * used at any time.  Gates are computed out-of-place in topological order.
+ * If the gates that need to be computed do not fit into the budget, the
+ * topological order is split in two halves.  The outputs of the first half
+ * are computed, then the values that the second half depends on, the second
+ * half is computed recursively, and the latter values of the first half are
+ * uncomputed again.  This trades additional gates for fewer ancillae.  If no
+ * schedule is found, `success()` returns false and no steps are given.
+ */
+template<class LogicNetwork>
+class pebbling_mapping_strategy {
+public:
+	pebbling_mapping_strategy(LogicNetwork const& ntk,
+	                          pebbling_mapping_strategy_params const& ps = {})
+	{
+		// clang-format off
+		static_assert(mt::is_network_type_v<LogicNetwork>, "LogicNetwork is not a network type");
+		static_assert(mt::has_foreach_po_v<LogicNetwork>, "LogicNetwork does not implement the foreach_po method");
+		static_assert(mt::has_is_constant_v<LogicNetwork>, "LogicNetwork does not implement the is_constant method");
+		static_assert(mt::has_is_pi_v<LogicNetwork>, "LogicNetwork does not implement the is_pi method");
+		static_assert(mt::has_get_node_v<LogicNetwork>, "LogicNetwork does not implement the get_node method");
+		static_assert(mt::has_node_to_index_v<LogicNetwork>, "LogicNetwork does not implement the node_to_index method");
+		static_assert(mt::has_fanout_size_v<LogicNetwork>, "LogicNetwork does not implement the fanout_size method");
+		static_assert(mt::has_foreach_fanin_v<LogicNetwork>, "LogicNetwork does not implement the foreach_fanin method");
+		// clang-format on
+
+		/* gates in topological order, referred to by their position */
+		std::vector<uint32_t> position(ntk.size(), 0u);
+		mt::topo_view view{ntk};
+		view.foreach_node([&](auto n) {
+			if (ntk.is_constant(n) || ntk.is_pi(n))
+				return true;
+			gates.push_back(n);
+			position[ntk.node_to_index(n)] = static_cast<uint32_t>(gates.size());
+			return true;
+		});
+
+		fanins.resize(gates.size());
+		for (auto i = 0u; i < gates.size(); ++i) {
+			ntk.foreach_fanin(gates[i], [&](auto const& f) {
+				if (const auto p = position[ntk.node_to_index(ntk.get_node(f))]; p != 0u)
+					fanins[i].push_back(p - 1u);
+			});
+		}
+
+		std::vector<uint32_t> targets;
+		ntk.foreach_po([&](auto const& f) {
+			if (const auto p = position[ntk.node_to_index(ntk.get_node(f))]; p != 0u)
+				targets.push_back(p - 1u);
+		});
+		std::sort(targets.begin(), targets.end());
+		targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+		/* qubits that are not available as ancillae (same as in logic_network_synthesis) */
+		auto num_fixed = ntk.num_pis();
+		const auto c0 = ntk.get_node(ntk.get_constant(false));
+		const auto c1 = ntk.get_node(ntk.get_constant(true));
+		num_fixed += ntk.fanout_size(c0) != 0u ? 1u : 0u;
+		if (c1 != c0)
+			num_fixed += ntk.fanout_size(c1) != 0u ? 1u : 0u;
+
+		if (ps.max_qubits == 0u)
+			limit = std::numeric_limits<uint32_t>::max();
+		else
+			limit = ps.max_qubits > num_fixed ? ps.max_qubits - num_fixed : 0u;
+
+		pebbled.resize(gates.size(), false);
+		marks.resize(gates.size(), 0u);
+		target_marks.resize(gates.size(), 0u);
+
+		_success = forward(0u, static_cast<uint32_t>(gates.size()), targets);
+		if (!_success)
+			steps.clear();
+		_num_qubits = num_fixed + max_pebbles;
+	}
+
+	template<class Fn>
+	inline void foreach_step(Fn&& fn) const
+	{
+		for (auto const& [p, compute] : steps) {
+			if (compute)
+				fn(gates[p], mapping_strategy_action{compute_action{}});
+			else
+				fn(gates[p], mapping_strategy_action{uncompute_action{}});
+		}
+	}
+
+	/*! \brief Returns whether a schedule within the qubit budget was found. */
+	bool success() const
+	{
+		return _success;
+	}
+
+	/*! \brief Returns the number of qubits used by the schedule. */
+	uint32_t num_qubits() const
+	{
+		return _num_qubits;
+	}
+
+	/*! \brief Returns the number of compute and uncompute steps. */
+	uint64_t num_steps() const
+	{
+		return steps.size();
+	}
+
+private:
+	/* pebbles the gates in targets and leaves all other gates in [a, b)
+	 * unchanged; all required gates before a must be pebbled */
+	bool forward(uint32_t a, uint32_t b, std::vector<uint32_t> const& targets)
+	{
+		const auto needed = needed_gates(a, b, targets);
+		if (needed.empty())
+			return true;
+
+		if (num_pebbled + needed.size() <= limit) {
+			++stamp;
+			for (auto t : targets)
+				target_marks[t] = stamp;
+
+			for (auto p : needed)
+				add_step(p, true);
+			for (auto it = needed.rbegin(); it != needed.rend(); ++it)
+				if (target_marks[*it] != stamp)
+					add_step(*it, false);
+			return true;
+		}
+
+		if (needed.size() == 1u)
+			return false;
+
+		/* split at the middle of the needed gates */
+		const auto m = needed[needed.size() / 2u];
+
+		std::vector<uint32_t> targets_first, targets_second;
+		for (auto t : targets) {
+			if (t < m) {
+				if (!pebbled[t])
+					targets_first.push_back(t);
+			} else {
+				targets_second.push_back(t);
+			}
+		}
+
+		/* needed gates in the first half with fanout into the second half */
+		++stamp;
+		for (auto t : targets_first)
+			target_marks[t] = stamp;
+		std::vector<uint32_t> cut;
+		for (auto it = std::lower_bound(needed.begin(), needed.end(), m); it != needed.end(); ++it) {
+			for (auto f : fanins[*it]) {
+				if (f >= a && f < m && target_marks[f] != stamp) {
+					target_marks[f] = stamp;
+					cut.push_back(f);
+				}
+			}
+		}
+		std::sort(cut.begin(), cut.end());
+
+		if (!forward(a, m, targets_first))
+			return false;
+
+		/* the cut is uncomputed while the targets of the second half are
+		 * pebbled, therefore their pebbles are reserved when computing it */
+		const auto reserved = static_cast<uint32_t>(std::count_if(
+		    targets_second.begin(), targets_second.end(), [&](auto t) { return !pebbled[t]; }));
+		if (reserved > limit)
+			return false;
+		limit -= reserved;
+		const auto begin_cut = steps.size();
+		const auto cut_computed = forward(a, m, cut);
+		const auto end_cut = steps.size();
+		limit += reserved;
+		if (!cut_computed)
+			return false;
+		if (!forward(m, b, targets_second))
+			return false;
+
+		/* uncompute the cut by reversing the steps that computed it */
+		for (auto i = end_cut; i > begin_cut; --i) {
+			const auto [p, compute] = steps[i - 1u];
+			add_step(p, !compute);
+		}
+		return true;
+	}
+
+	/* gates in [a, b) that are in the transitive fanin of targets and not pebbled, in topological order */
+	std::vector<uint32_t> needed_gates(uint32_t a, uint32_t b, std::vector<uint32_t> const& targets)
+	{
+		++stamp;
+		for (auto t : targets)
+			if (!pebbled[t])
+				marks[t] = stamp;
+
+		std::vector<uint32_t> needed;
+		for (auto i = b; i > a; --i) {
+			const auto p = i - 1u;
+			if (marks[p] != stamp)
+				continue;
+			needed.push_back(p);
+			for (auto f : fanins[p]) {
+				if (f >= a && !pebbled[f])
+					marks[f] = stamp;
+			}
+		}
+		std::reverse(needed.begin(), needed.end());
+		return needed;
+	}
+
+	void add_step(uint32_t p, bool compute)
+	{
+		steps.emplace_back(p, compute);
+		pebbled[p] = compute;
+		if (compute) {
+			max_pebbles = std::max(max_pebbles, ++num_pebbled);
+		} else {
+			--num_pebbled;
+		}
+	}
+
+private:
+	std::vector<mt::node<LogicNetwork>> gates;
+	std::vector<std::vector<uint32_t>> fanins;
+	std::vector<std::pair<uint32_t, bool>> steps;
+
+	std::vector<bool> pebbled;
+	std::vector<uint32_t> marks, target_marks;
+	uint32_t stamp{0};
+
+	uint32_t limit{0};
+	uint32_t num_pebbled{0};
+	uint32_t max_pebbles{0};
+	uint32_t _num_qubits{0};
+	bool _success{false};
+};
+
+/*! \brief Order in which released ancillae are reused. */
+enum class ancilla_policy_t {
+	/*! Most recently released ancilla first */
+	lifo,
+	/*! Least recently released ancilla first */
+	fifo,
+	/*! Ancilla whose last gate is earliest in an ASAP schedule first */
+	lru
 };
 
 struct logic_network_synthesis_params {
 	bool verbose{false};
+
+	/*! \brief Policy to reuse released ancillae. */
+	ancilla_policy_t ancilla_policy{ancilla_policy_t::lifo};
+};
+
+struct logic_network_synthesis_stats {
+	/*! \brief Number of ancillae (qubits that are not inputs or constants). */
+	uint32_t num_ancillae{0};
+
+	/*! \brief Depth of the circuit in an ASAP schedule of its gates. */
+	uint32_t depth{0};
+
+	/*! \brief Qubit that holds each primary output (without its complement). */
+	std::vector<uint32_t> output_qubits;
 };
 
 namespace detail {
@@ -185,21 +450,28 @@ template<class QuantumNetwork, class LogicNetwork, class MappingStrategy>
 class logic_network_synthesis_impl {
 public:
 	logic_network_synthesis_impl(QuantumNetwork& qnet, LogicNetwork const& ntk,
-	                             logic_network_synthesis_params const& ps)
+	                             logic_network_synthesis_params const& ps,
+	                             logic_network_synthesis_stats* pst = nullptr)
 	    : qnet(qnet)
 	    , ntk(ntk)
 	    , ps(ps)
+	    , pst(pst)
 	    , node_to_qubit(ntk)
 	{}
 
 	void run()
+	{
+		MappingStrategy strategy{ntk};
+		run(strategy);
+	}
+
+	void run(MappingStrategy const& strategy)
 	{
 		prepare_inputs();
 		prepare_constant(false);
 		if (ntk.get_node(ntk.get_constant(false)) != ntk.get_node(ntk.get_constant(true)))
 			prepare_constant(true);
 
-		MappingStrategy strategy{ntk};
 		strategy.foreach_step([&](auto node, auto action) {
 			std::visit(
 			    overloaded{
@@ -210,6 +482,7 @@ public:
 					                  << ntk.node_to_index(node) << "\n";
 				        const auto t = node_to_qubit[node] = request_ancilla();
 				        compute_node(node, t);
+				        touch(node, t);
 			        },
 			        [&](uncompute_action const&) {
 				        if (ps.verbose)
@@ -217,6 +490,7 @@ public:
 					                  << ntk.node_to_index(node) << "\n";
 				        const auto t = node_to_qubit[node];
 				        compute_node(node, t);
+				        touch(node, t);
 				        release_ancilla(t);
 			        },
 			        [&](compute_inplace_action const& action) {
@@ -228,6 +502,7 @@ public:
 				        const auto t = node_to_qubit[node]
 				            = node_to_qubit[ntk.index_to_node(action.target_index)];
 				        compute_node_inplace(node, t);
+				        touch(node, t);
 			        },
 			        [&](uncompute_inplace_action const& action) {
 				        if (ps.verbose)
@@ -237,9 +512,19 @@ public:
 					                  << "\n";
 				        const auto t = node_to_qubit[node];
 				        compute_node_inplace(node, t);
+				        touch(node, t);
 			        }},
 			    action);
 		});
+
+		if (pst) {
+			pst->num_ancillae = num_ancillae;
+			pst->depth = compute_depth();
+			pst->output_qubits.clear();
+			ntk.foreach_po([&](auto const& f) {
+				pst->output_qubits.push_back(node_to_qubit[ntk.get_node(f)]);
+			});
+		}
 	}
 
 private:
@@ -267,20 +552,72 @@ private:
 
 	uint32_t request_ancilla()
 	{
-		if (free_ancillae.empty()) {
+		if (free_ancillae.empty() && free_ancillae_by_level.empty()) {
 			const auto r = qnet.num_qubits();
 			qnet.add_qubit();
+			++num_ancillae;
 			return r;
-		} else {
-			const auto r = free_ancillae.top();
-			free_ancillae.pop();
-			return r;
 		}
+
+		uint32_t r;
+		switch (ps.ancilla_policy) {
+		default:
+		case ancilla_policy_t::lifo:
+			r = free_ancillae.back();
+			free_ancillae.pop_back();
+			break;
+		case ancilla_policy_t::fifo:
+			r = free_ancillae.front();
+			free_ancillae.pop_front();
+			break;
+		case ancilla_policy_t::lru:
+			r = free_ancillae_by_level.begin()->second;
+			free_ancillae_by_level.erase(free_ancillae_by_level.begin());
+			break;
+		}
+		return r;
 	}
 
 	void release_ancilla(uint32_t q)
 	{
-		free_ancillae.push(q);
+		if (ps.ancilla_policy == ancilla_policy_t::lru)
+			free_ancillae_by_level.emplace(qubit_level[q], q);
+		else
+			free_ancillae.push_back(q);
+	}
+
+	/* updates the ASAP levels of the qubits that are used to compute node onto t;
+	 * every compute step is counted as one level */
+	void touch(mt::node<LogicNetwork> const& node, uint32_t t)
+	{
+		if (qubit_level.size() < qnet.num_qubits())
+			qubit_level.resize(qnet.num_qubits(), 0u);
+
+		auto level = qubit_level[t];
+		ntk.foreach_fanin(node, [&](auto const& f) {
+			level = std::max(level, qubit_level[node_to_qubit[ntk.get_node(f)]]);
+		});
+		++level;
+		qubit_level[t] = level;
+		ntk.foreach_fanin(node, [&](auto const& f) {
+			qubit_level[node_to_qubit[ntk.get_node(f)]] = level;
+		});
+	}
+
+	uint32_t compute_depth() const
+	{
+		std::vector<uint32_t> levels(qnet.num_qubits(), 0u);
+		uint32_t depth{0};
+		qnet.foreach_cgate([&](auto const& n) {
+			uint32_t level{0};
+			n.gate.foreach_control([&](auto q) { level = std::max(level, levels[q]); });
+			n.gate.foreach_target([&](auto q) { level = std::max(level, levels[q]); });
+			++level;
+			n.gate.foreach_control([&](auto q) { levels[q] = level; });
+			n.gate.foreach_target([&](auto q) { levels[q] = level; });
+			depth = std::max(depth, level);
+		});
+		return depth;
 	}
 
 	template<int Fanin>
@@ -540,8 +877,12 @@ private:
 	QuantumNetwork& qnet;
 	LogicNetwork const& ntk;
 	logic_network_synthesis_params const& ps;
+	logic_network_synthesis_stats* pst;
 	mt::node_map<uint32_t, LogicNetwork> node_to_qubit;
-	std::stack<uint32_t> free_ancillae;
+	std::deque<uint32_t> free_ancillae;
+	std::set<std::pair<uint32_t, uint32_t>> free_ancillae_by_level;
+	std::vector<uint32_t> qubit_level;
+	uint32_t num_ancillae{0};
 };
 
 } // namespace detail
@@ -559,14 +900,36 @@ private:
 template<class QuantumNetwork, class LogicNetwork,
          class MappingStrategy = bennett_inplace_mapping_strategy<LogicNetwork>>
 void logic_network_synthesis(QuantumNetwork& qnet, LogicNetwork const& ntk,
-                             logic_network_synthesis_params const& ps = {})
+                             logic_network_synthesis_params const& ps = {},
+                             logic_network_synthesis_stats* pst = nullptr)
 {
 	static_assert(mt::is_network_type_v<LogicNetwork>, "LogicNetwork is not a network type");
 
 	detail::logic_network_synthesis_impl<QuantumNetwork, LogicNetwork, MappingStrategy> impl(qnet,
 	                                                                                         ntk,
-	                                                                                         ps);
+	                                                                                         ps,
+	                                                                                         pst);
 	impl.run();
 }
 
+/*! \brief Hierarchical synthesis based on a logic network and a mapping strategy
+ *
+ * Same as above, but uses a mapping strategy that has already been
+ * constructed, e.g., with strategy-specific parameters.
+ */
+template<class QuantumNetwork, class LogicNetwork, class MappingStrategy>
+void logic_network_synthesis(QuantumNetwork& qnet, LogicNetwork const& ntk,
+                             MappingStrategy const& strategy,
+                             logic_network_synthesis_params const& ps = {},
+                             logic_network_synthesis_stats* pst = nullptr)
+{
+	static_assert(mt::is_network_type_v<LogicNetwork>, "LogicNetwork is not a network type");
+
+	detail::logic_network_synthesis_impl<QuantumNetwork, LogicNetwork, MappingStrategy> impl(qnet,
+	                                                                                         ntk,
+	                                                                                         ps,
+	                                                                                         pst);
+	impl.run(strategy);
+}
+
 } /* namespace tweedledum */
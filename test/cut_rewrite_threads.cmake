@@ -0,0 +1,45 @@
+# Exact cut rewriting must give the same network with one and with several threads
+#
+# The input is a ripple-carry adder of 2-input LUTs, such that cut rewriting
+# requests functions with fewer and with more variables than the LUT size
+# of the exact resynthesis engine.
+
+set(num_bits 8)
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+set(bench "INPUT(c0)\n")
+math(EXPR last "${num_bits} - 1")
+foreach(i RANGE ${last})
+  string(APPEND bench "INPUT(a${i})\nINPUT(b${i})\n")
+endforeach()
+foreach(i RANGE ${last})
+  string(APPEND bench "OUTPUT(s${i})\n")
+endforeach()
+string(APPEND bench "OUTPUT(c${num_bits})\n")
+foreach(i RANGE ${last})
+  math(EXPR j "${i} + 1")
+  string(APPEND bench "p${i} = LUT 0x6 (a${i}, b${i})\n")
+  string(APPEND bench "g${i} = LUT 0x8 (a${i}, b${i})\n")
+  string(APPEND bench "s${i} = LUT 0x6 (p${i}, c${i})\n")
+  string(APPEND bench "t${i} = LUT 0x8 (p${i}, c${i})\n")
+  string(APPEND bench "c${j} = LUT 0xe (g${i}, t${i})\n")
+endforeach()
+file(WRITE ${WORK_DIR}/adder.bench "${bench}")
+
+foreach(threads 1 8)
+  execute_process(
+    COMMAND ${CIRKIT} -c "read_bench -l ${WORK_DIR}/adder.bench; cut_rewrite -l -k 4 --strategy 1 --exact_lutsize 3 --threads ${threads}; write_bench -l ${WORK_DIR}/out${threads}.bench"
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "cirkit failed with ${threads} threads")
+  endif()
+endforeach()
+
+file(READ ${WORK_DIR}/out1.bench out1)
+file(READ ${WORK_DIR}/out8.bench out8)
+if(out1 STREQUAL "")
+  message(FATAL_ERROR "no network written")
+endif()
+if(NOT out1 STREQUAL out8)
+  message(FATAL_ERROR "cut rewriting with 1 and 8 threads gives different networks")
+endif()